@@ -1,6 +1,7 @@
 #include "banner.h"
 #include "filesystem.h"
 #include "memory.h"
+#include "timer.h"
 
 // Simple memory allocation for banner frames
 #define MAX_BANNER_FRAMES 100
@@ -19,14 +20,9 @@ static struct banner_frame* allocate_frame() {
     return &allocated_frames[frame_allocated_count++];
 }
 
-// Get current time (simple counter-based)
-// Note: This is a simple approximation. For accurate timing, use PIT or RTC
+// Kare zamanlaması timer tick'lerinden (TIMER_MS_PER_TICK çözünürlükte)
 static uint32_t get_time_ms() {
-    // Simple counter - in real implementation, use PIT or RTC
-    static uint32_t time_counter = 0;
-    time_counter++;
-    // Rough approximation: each call increments by ~1/7 ms
-    return time_counter / 7;
+    return timer_ticks() * TIMER_MS_PER_TICK;
 }
 
 // Load a banner frame from file
@@ -73,7 +69,7 @@ void banner_load_frame(struct banner* b, uint32_t frame_index, const char* filen
     frame->delay_ms = delay_ms;
     
     // Allocate pixel data first (before reading to avoid OOM)
-    frame->pixels = (uint32_t*)kmalloc(pixel_count * sizeof(uint32_t));
+    frame->pixels = (uint32_t*)kmalloc_aligned(pixel_count * sizeof(uint32_t), 64);
     
     if (!frame->pixels) return;
     
@@ -127,7 +123,7 @@ void banner_load_frame_data(struct banner* b, uint32_t frame_index, uint32_t wid
     
     // Allocate and copy pixel data
     uint32_t pixel_count = width * height;
-    frame->pixels = (uint32_t*)kmalloc(pixel_count * sizeof(uint32_t));
+    frame->pixels = (uint32_t*)kmalloc_aligned(pixel_count * sizeof(uint32_t), 64);
     
     if (!frame->pixels) return;
     
@@ -166,6 +162,14 @@ void banner_update(struct banner* b) {
     }
 }
 
+// Sıradaki kareye kaç ms var (aktif değilse 0)
+uint32_t banner_ms_until_next(struct banner* b) {
+    if (!b || !b->active || b->current_frame >= b->num_frames) return 0;
+    uint32_t elapsed = get_time_ms() - b->last_frame_time;
+    uint32_t delay = b->frames[b->current_frame].delay_ms;
+    return elapsed < delay ? delay - elapsed : 0;
+}
+
 // Draw current banner frame
 void banner_draw(struct banner* b) {
     if (!b || !b->active || b->num_frames == 0) return;
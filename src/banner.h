@@ -27,6 +27,7 @@ void banner_init(struct banner* b, int x, int y);
 void banner_load_frame(struct banner* b, uint32_t frame_index, const char* filename);
 void banner_load_frame_data(struct banner* b, uint32_t frame_index, uint32_t width, uint32_t height, uint32_t* pixels, uint32_t delay_ms);
 void banner_update(struct banner* b);
+uint32_t banner_ms_until_next(struct banner* b);
 void banner_draw(struct banner* b);
 void banner_cleanup(struct banner* b);
 void banner_set_active(struct banner* b, int active);
@@ -27,12 +27,26 @@ align 8
     dd 8                        ; size
 header_end:
 
+; Kernel KERNEL_VIRT_BASE + 1MB'a link edilir ama 1MB'a yüklenir; paging
+; açılana kadar semboller PHYS() ile fiziksel adresinden kullanılır
+KERNEL_VIRT_BASE equ 0xC0000000
+%define PHYS(x) ((x) - KERNEL_VIRT_BASE)
+
 section .bss
 align 16
 stack_bottom:
     resb 16384
 stack_top:
 
+; Geçici boot directory'si: ilk 4MB hem identity (paging açılırken çalışan
+; kod) hem KERNEL_VIRT_BASE'te. paging_init kendi directory'sine geçince
+; identity eşleme kalkar.
+alignb 4096
+boot_pd:
+    resd 1024
+boot_pt:
+    resd 1024
+
 section .text
 bits 32
 global _start
@@ -44,35 +58,44 @@ global fb_width
 global fb_height
 global fb_pitch
 
+; Multiboot2 info and memory map tag for the physical memory manager
+global multiboot_info
+global mb_mmap_tag
+
 framebuffer: dd 0
 fb_width: dd 0
 fb_height: dd 0
 fb_pitch: dd 0
+multiboot_info: dd 0
+mb_mmap_tag: dd 0
 
 _start:
-    mov esp, stack_top
     cli
     
-    ; Save multiboot info
-    push ebx  ; multiboot info
-    push eax  ; multiboot magic
+    ; Multiboot magic edi'de, info ebx'te kalır (ikisi de kernel_main'e)
+    mov edi, eax
     
     ; Check multiboot magic
     cmp eax, 0x36d76289
-    jne .call_kernel
+    jne .enable_paging
     
-    ; Find framebuffer tag
+    mov [PHYS(multiboot_info)], ebx
+
+    ; Walk tags: framebuffer and memory map
     mov esi, ebx
     add esi, 8              ; skip size and reserved
     
 .find_fb:
     mov eax, [esi]          ; tag type
     test eax, eax           ; end tag?
-    jz .call_kernel
+    jz .enable_paging
     cmp eax, 8              ; framebuffer tag?
     je .found_fb
+    cmp eax, 6              ; memory map tag?
+    jne .next_tag
+    mov [PHYS(mb_mmap_tag)], esi
     
-    ; Next tag
+.next_tag:
     mov ecx, [esi + 4]      ; tag size
     add ecx, 7
     and ecx, ~7             ; align to 8
@@ -82,16 +105,47 @@ _start:
 .found_fb:
     ; Get framebuffer info and store in global variables
     mov eax, [esi + 8]      ; framebuffer address
-    mov [framebuffer], eax
+    mov [PHYS(framebuffer)], eax
     mov eax, [esi + 16]     ; pitch
-    mov [fb_pitch], eax
+    mov [PHYS(fb_pitch)], eax
     mov eax, [esi + 20]     ; width
-    mov [fb_width], eax
+    mov [PHYS(fb_width)], eax
     mov eax, [esi + 24]     ; height
-    mov [fb_height], eax
+    mov [PHYS(fb_height)], eax
+    jmp .next_tag
+    
+.enable_paging:
+    ; boot_pt: ilk 4MB, 4KB sayfalarla (PSE gerekmez)
+    xor ecx, ecx
+.fill_pt:
+    mov eax, ecx
+    shl eax, 12
+    or eax, 0x003           ; present | write
+    mov [PHYS(boot_pt) + ecx * 4], eax
+    mov dword [PHYS(boot_pd) + ecx * 4], 0
+    inc ecx
+    cmp ecx, 1024
+    jb .fill_pt
+    
+    mov eax, PHYS(boot_pt) + 0x003
+    mov [PHYS(boot_pd)], eax
+    mov [PHYS(boot_pd) + (KERNEL_VIRT_BASE >> 22) * 4], eax
+    mov eax, PHYS(boot_pd)
+    mov cr3, eax
+    mov eax, cr0
+    or eax, 0x80000000      ; PG
+    mov cr0, eax
+    
+    ; Artık link adreslerinde çalışabiliriz
+    mov eax, .higher_half
+    jmp eax
+    
+.higher_half:
+    mov esp, stack_top
     
-.call_kernel:
     ; Call the kernel with multiboot parameters
+    push ebx  ; multiboot info
+    push edi  ; multiboot magic
     call kernel_main
     
     ; Clean up stack
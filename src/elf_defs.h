@@ -91,6 +91,7 @@ typedef struct {
 #define AT_ENTRY    9
 #define AT_EXECFN   31
 #define AT_BASE     7
+#define AT_SYSINFO_EHDR 33  // vDSO'nun ELF header'ı
 
 // For 32-bit, use 32-bit structures
 #define ELFCLASS ELFCLASS32
@@ -3,6 +3,9 @@
 #include "process.h"
 #include "vga.h"
 #include "io.h"
+#include "pagecache.h"
+#include "timer.h"
+#include "workqueue.h"
 
 // Active ATA I/O ports (default: primary bus). Updated during detection.
 static uint16_t ata_io_base = 0x1F0;
@@ -31,6 +34,12 @@ static int is_atapi_device = 0;
 static uint8_t* ramdisk_buffer = 0;
 static uint32_t ramdisk_total_sectors = 0;
 static uint8_t ramdisk_enabled = 0;
+static uint32_t ramdisk_iso_sectors = 0;   // LBA 0'dan itibaren ramdisk'e kopyalanmış ISO sektörleri
+// Preload sürerken: bit'i 1 olan 2048'lik block cihazdan henüz kopyalanmadı.
+// 0 ise ramdisk'in tamamı geçerli.
+static uint32_t* ramdisk_pending = 0;
+
+static void ramdisk_fault(uint32_t lba);
 
 // Device type detection
 typedef enum {
@@ -62,12 +71,6 @@ static int strncmp_case_insensitive(const char* a, const char* b, int n) {
 }
 static char* strchr_local(const char* str, char c) { while (*str != '\0') { if (*str == c) return (char*)str; str++; } return 0; }
 
-static void* memset(void* dest, int c, uint32_t n) {
-    uint8_t* d = (uint8_t*)dest;
-    for (uint32_t i = 0; i < n; i++) d[i] = (uint8_t)c;
-    return dest;
-}
-
 static void* memcpy(void* dest, const void* src, uint32_t n) {
     uint8_t* d = (uint8_t*)dest;
     const uint8_t* s = (const uint8_t*)src;
@@ -87,28 +90,33 @@ static void* memcpy(void* dest, const void* src, uint32_t n) {
 #define ATA_CMD_IDENTIFY        0xEC
 #define ATA_CMD_IDENTIFY_PACKET 0xA1
 
+// Bekleme süreleri: iterasyon sayısı değil gerçek zaman (CPU hızından bağımsız)
+#define ATA_TIMEOUT_MS          1000    // Komut başına
+#define ATAPI_SEEK_TIMEOUT_MS   5000    // READ(10): seek ve spin-up
+
+// Status register'ı (status & mask) == value olana kadar oku; BSY kalkmışken
+// ERR gelirse de durur. Son status'u, süre dolduysa -1 döner. Süre TSC ile
+// ölçülür, interrupt'lar kapalıyken (syscall'lar) de işler.
+static int ata_wait(uint8_t mask, uint8_t value, uint32_t ms) {
+    uint64_t deadline = timer_deadline_us(ms * 1000);
+    do {
+        uint8_t status = inb(DISK_STATUS_PORT);
+        if ((status & mask) == value) return status;
+        if (!(status & ATA_SR_BSY) && (status & ATA_SR_ERR)) return status;
+    } while (!timer_expired(deadline));
+    return -1;
+}
+
 // Wait for BSY to clear
 static int ata_wait_bsy() {
     for (int i = 0; i < 4; i++) inb(DISK_STATUS_PORT);
-    
-    for (int i = 0; i < 10000; i++) {
-        uint8_t status = inb(DISK_STATUS_PORT);
-        if (!(status & ATA_SR_BSY))
-            return 0;
-    }
-    return -1;
+    return ata_wait(ATA_SR_BSY, 0, ATA_TIMEOUT_MS) < 0 ? -1 : 0;
 }
 
 // Wait for DRQ to be set
 static int ata_wait_drq_set() {
-    for (int i = 0; i < 10000; i++) {
-        uint8_t status = inb(DISK_STATUS_PORT);
-        if (status & ATA_SR_DRQ)
-            return 0;
-        if (status & ATA_SR_ERR)
-            return -1;
-    }
-    return -1;
+    int status = ata_wait(ATA_SR_DRQ, ATA_SR_DRQ, ATA_TIMEOUT_MS);
+    return (status < 0 || !(status & ATA_SR_DRQ)) ? -1 : 0;
 }
 
 // Read 256 words from disk data port
@@ -124,7 +132,7 @@ static DeviceType detect_device_on_bus(uint16_t io_base, uint16_t ctrl_port) {
 
     // Select primary/secondary master on this bus
     outb(DISK_DRIVE_PORT, 0xA0);
-    for (volatile int i = 0; i < 100000; i++);
+    timer_udelay(1000);
     
     // Check for ATAPI signature FIRST (before any commands)
     uint8_t lba_mid = inb(DISK_LBA_MID_PORT);
@@ -156,10 +164,7 @@ static DeviceType detect_device_on_bus(uint16_t io_base, uint16_t ctrl_port) {
     }
     
     // Wait for not busy
-    int timeout = 0;
-    while ((inb(DISK_STATUS_PORT) & 0x80) && timeout++ < 100000);
-    
-    if (timeout >= 100000) {
+    if (ata_wait(ATA_SR_BSY, 0, ATA_TIMEOUT_MS) < 0) {
         print_color("Device busy timeout on this bus\n", VGA_COLOR_YELLOW);
         return DEVICE_TYPE_NONE;
     }
@@ -167,7 +172,7 @@ static DeviceType detect_device_on_bus(uint16_t io_base, uint16_t ctrl_port) {
     // Try IDENTIFY command
     outb(DISK_COMMAND_PORT, ATA_CMD_IDENTIFY);
     
-    for (volatile int i = 0; i < 400; i++) inb(DISK_STATUS_PORT);
+    ata_wait_bsy();
     
     status = inb(DISK_STATUS_PORT);
     
@@ -190,19 +195,13 @@ static DeviceType detect_device_on_bus(uint16_t io_base, uint16_t ctrl_port) {
         
         // Send DEVICE RESET
         outb(DISK_COMMAND_PORT, 0x08);
-        for (volatile int i = 0; i < 50000; i++);
+        ata_wait_bsy();
         
         outb(DISK_DRIVE_PORT, 0xA0);
-        for (volatile int i = 0; i < 1000; i++);
+        inb(DISK_STATUS_PORT); inb(DISK_STATUS_PORT); inb(DISK_STATUS_PORT); inb(DISK_STATUS_PORT);
         outb(DISK_COMMAND_PORT, ATA_CMD_IDENTIFY_PACKET);
         
-        timeout = 0;
-        while ((inb(DISK_STATUS_PORT) & 0x80) && timeout++ < 100000);
-        
-        timeout = 0;
-        while (!(inb(DISK_STATUS_PORT) & 0x08) && timeout++ < 100000);
-        
-        if (timeout < 100000) {
+        if (ata_wait_bsy() == 0 && ata_wait_drq_set() == 0) {
             uint16_t identify_buf[256];
             read_identify_buffer(identify_buf);
         }
@@ -219,10 +218,7 @@ static DeviceType detect_device_on_bus(uint16_t io_base, uint16_t ctrl_port) {
     }
     
     // Wait for DRQ
-    timeout = 0;
-    while (!(inb(DISK_STATUS_PORT) & 0x08) && timeout++ < 100000);
-    
-    if (timeout >= 100000) {
+    if (ata_wait_drq_set() < 0) {
         print_color("No DRQ on this bus\n", VGA_COLOR_YELLOW);
         return DEVICE_TYPE_NONE;
     }
@@ -256,11 +252,7 @@ static int atapi_read_block_2048(uint32_t lba, char* buffer) {
     inb(DISK_STATUS_PORT); inb(DISK_STATUS_PORT); inb(DISK_STATUS_PORT); inb(DISK_STATUS_PORT);
     
     // Wait for BSY=0, DRDY=1
-    int timeout = 100000;
-    while (timeout--) {
-        uint8_t status = inb(DISK_STATUS_PORT);
-        if (!(status & 0x80) && (status & 0x40)) break;
-    }
+    ata_wait(ATA_SR_BSY | ATA_SR_DRDY, ATA_SR_DRDY, ATA_TIMEOUT_MS);
     
     // Set Features register (use DMA=0, overlap=0)
     outb(DISK_ERROR_PORT, 0x00);
@@ -276,23 +268,15 @@ static int atapi_read_block_2048(uint32_t lba, char* buffer) {
     inb(DISK_STATUS_PORT); inb(DISK_STATUS_PORT); inb(DISK_STATUS_PORT); inb(DISK_STATUS_PORT);
     
     // Wait for BSY=0
-    timeout = 100000;
-    while (timeout--) {
-        if (!(inb(DISK_STATUS_PORT) & 0x80)) break;
-    }
+    ata_wait(ATA_SR_BSY, 0, ATA_TIMEOUT_MS);
     
     // Check for error
-    uint8_t status = inb(DISK_STATUS_PORT);
+    int status = inb(DISK_STATUS_PORT);
     if (status & 0x01) return -1;
     
     // Wait for DRQ=1 (ready for packet)
-    timeout = 100000;
-    while (timeout--) {
-        status = inb(DISK_STATUS_PORT);
-        if (status & 0x08) break;
-        if (status & 0x01) return -1;
-    }
-    if (!(status & 0x08)) return -1;
+    status = ata_wait(ATA_SR_DRQ, ATA_SR_DRQ, ATA_TIMEOUT_MS);
+    if (status < 0 || !(status & 0x08)) return -1;
     
     // Prepare READ(10) SCSI command packet (12 bytes)
     // SCSI commands are BIG-ENDIAN, but we send as little-endian WORDS
@@ -321,11 +305,8 @@ static int atapi_read_block_2048(uint32_t lba, char* buffer) {
         outw(DISK_DATA_PORT, packet[i]);
     }
     
-    // Wait for BSY=0 (command processing)
-    timeout = 1000000;  // Longer timeout for seeking
-    while (timeout--) {
-        if (!(inb(DISK_STATUS_PORT) & 0x80)) break;
-    }
+    // Wait for BSY=0 (command processing, longer timeout for seeking)
+    ata_wait(ATA_SR_BSY, 0, ATAPI_SEEK_TIMEOUT_MS);
     
     // Check for error after command
     status = inb(DISK_STATUS_PORT);
@@ -335,13 +316,8 @@ static int atapi_read_block_2048(uint32_t lba, char* buffer) {
     }
     
     // Wait for DRQ=1 (data ready)
-    timeout = 1000000;
-    while (timeout--) {
-        status = inb(DISK_STATUS_PORT);
-        if (status & 0x08) break;
-        if (status & 0x01) return -1;
-    }
-    if (!(status & 0x08)) return -1;
+    status = ata_wait(ATA_SR_DRQ, ATA_SR_DRQ, ATAPI_SEEK_TIMEOUT_MS);
+    if (status < 0 || !(status & 0x08)) return -1;
     
     // Read actual byte count device is sending
     uint16_t byte_count = inb(DISK_LBA_MID_PORT) | (inb(DISK_LBA_HIGH_PORT) << 8);
@@ -363,27 +339,19 @@ static int atapi_read_block_2048(uint32_t lba, char* buffer) {
     }
     
     // Wait for command complete (BSY=0, DRQ=0)
-    timeout = 100000;
-    while (timeout--) {
-        status = inb(DISK_STATUS_PORT);
-        if (!(status & 0x88)) break;  // !BSY && !DRQ
-    }
+    ata_wait(ATA_SR_BSY | ATA_SR_DRQ, 0, ATA_TIMEOUT_MS);
     
     return 0;
 }
 
 int disk_wait() {
-    uint32_t attempts = 1000000;
-    while (attempts--) {
-        uint8_t status = inb(DISK_STATUS_PORT);
-        if ((status & 0x80) == 0) return 0;
-    }
-    return -1;
+    return ata_wait(ATA_SR_BSY, 0, ATA_TIMEOUT_MS) < 0 ? -1 : 0;
 }
 
 int disk_read_sector(uint32_t lba, char* buffer) {
     if (ramdisk_enabled) {
         if (lba >= ramdisk_total_sectors) return -1;
+        ramdisk_fault(lba);
         memcpy(buffer, ramdisk_buffer + (lba * 512), 512);
         return 0;
     }
@@ -412,13 +380,8 @@ int disk_read_sector(uint32_t lba, char* buffer) {
     outb(DISK_DRIVE_PORT, (uint8_t)(((lba >> 24) & 0x0F) | 0xE0));
     outb(DISK_COMMAND_PORT, 0x20);
     
-    uint32_t attempts = 1000000;
-    while (attempts--) {
-        uint8_t status = inb(DISK_STATUS_PORT);
-        if (status & 0x01) return -1;
-        if (status & 0x08) break;
-    }
-    if ((inb(DISK_STATUS_PORT) & 0x08) == 0) return -1;
+    int status = ata_wait(ATA_SR_DRQ, ATA_SR_DRQ, ATA_TIMEOUT_MS);
+    if (status < 0 || !(status & ATA_SR_DRQ)) return -1;
     
     for (int i = 0; i < 256; i++) {
         uint16_t data = inw(DISK_DATA_PORT);
@@ -431,6 +394,7 @@ int disk_read_sector(uint32_t lba, char* buffer) {
 int disk_write_sector(uint32_t lba, char* buffer) {
     if (ramdisk_enabled) {
         if (lba >= ramdisk_total_sectors) return -1;
+        ramdisk_fault(lba);     // Block'un kalan sektörleri ISO'dan gelmeli
         memcpy(ramdisk_buffer + (lba * 512), buffer, 512);
         return 0;
     }
@@ -449,19 +413,15 @@ int disk_write_sector(uint32_t lba, char* buffer) {
         outw(DISK_DATA_PORT, data);
     }
     
-    uint32_t attempts2 = 1000000;
-    while (attempts2--) {
-        uint8_t status = inb(DISK_STATUS_PORT);
-        if (status & 0x01) return -1;
-        if ((status & 0x80) == 0) break;
-    }
-    if ((inb(DISK_STATUS_PORT) & 0x80) != 0) return -1;
+    int status = ata_wait(ATA_SR_BSY, 0, ATA_TIMEOUT_MS);
+    if (status < 0 || (status & ATA_SR_ERR)) return -1;
     
     return 0;
 }
 
 // --- ISO9660 minimal reader from RAM overlay ---
-static int iso_read_block2048(uint32_t lba2048, char* out2048) {
+// Cihazdan (ramdisk'i atlayarak) tek 2048 byte'lık block oku
+static int iso_read_device_block2048(uint32_t lba2048, char* out2048) {
     uint8_t prev = ramdisk_enabled;
     ramdisk_enabled = 0;
     
@@ -483,6 +443,35 @@ static int iso_read_block2048(uint32_t lba2048, char* out2048) {
     return 0;
 }
 
+// Preload'un henüz gelmediği block'a erişildi: block'u cihazdan hemen
+// kopyala, preload sırası gelince onu atlar. Okunamazsa sıfır kalır.
+static void ramdisk_fault(uint32_t lba) {
+    uint32_t blk = lba / 4;
+    if (!ramdisk_pending || !(ramdisk_pending[blk / 32] & (1u << (blk % 32)))) return;
+
+    char buf[2048];
+    if (iso_read_device_block2048(blk, buf) != 0) {
+        for (int i = 0; i < 2048; i++) buf[i] = 0;
+    }
+    uint32_t first = blk * 4;
+    uint32_t count = ramdisk_total_sectors - first < 4 ? ramdisk_total_sectors - first : 4;
+    memcpy(ramdisk_buffer + first * 512, buf, count * 512);
+    ramdisk_pending[blk / 32] &= ~(1u << (blk % 32));
+}
+
+// ISO block'unun page cache'teki kopyası (her 4KB sayfa iki ISO block'u)
+static const uint8_t* iso_block(uint32_t lba2048) {
+    const uint8_t* page = pagecache_get(PAGECACHE_DEV_ISO, lba2048 / 2);
+    return page ? page + (lba2048 & 1) * ATAPI_SECTOR_SIZE : 0;
+}
+
+static int iso_read_block2048(uint32_t lba2048, char* out2048) {
+    const uint8_t* blk = iso_block(lba2048);
+    if (!blk) return iso_read_device_block2048(lba2048, out2048);
+    memcpy(out2048, blk, ATAPI_SECTOR_SIZE);
+    return 0;
+}
+
 static int iso_get_volume_size_blocks(uint32_t* out_blocks2048) {
     char pvd[2048];
     
@@ -699,10 +688,11 @@ static void fs_ensure_header_initialized() {
 void ramdisk_init(uint32_t total_sectors) {
     if (ramdisk_enabled) return;
     uint32_t bytes = total_sectors * 512;
-    ramdisk_buffer = (uint8_t*)kmalloc(bytes);
+    // Sayfa hizalı, heap'i 64MB'lık bir block ile şişirmesin.
+    // Boşta önceden sıfırlanmış sayfalar tekrar memset edilmez.
+    ramdisk_buffer = (uint8_t*)kpage_zalloc((bytes + PAGE_SIZE - 1) / PAGE_SIZE);
     if (ramdisk_buffer) {
         ramdisk_total_sectors = total_sectors;
-        memset(ramdisk_buffer, 0, bytes);
         ramdisk_enabled = 1;
         print("RAM disk enabled (");
         char mbuf[16]; int pos = 0; uint32_t v = bytes / (1024*1024); 
@@ -734,130 +724,166 @@ void ramdisk_init_auto() {
     print("ERROR: Could not allocate any ramdisk size\n");
 }
 
-void ramdisk_preload_from_lba(uint32_t start_lba, uint32_t sector_count) {
+static void ramdisk_print_progress(uint32_t done, uint32_t total) {
+    const uint32_t bar_width = 30;
+    uint32_t percent = (done * 100) / total;
+    char bar[31];
+    uint32_t filled = (percent * bar_width) / 100;
+    for (uint32_t j = 0; j < bar_width; j++) bar[j] = (j < filled) ? '#' : '-';
+    bar[bar_width] = '\0';
+
+    print("  ["); print(bar); print("] ");
+    // Percent
+    char pbuf[4]; int p = percent; int ppos = 0;
+    if (p == 0) pbuf[ppos++] = '0';
+    else {
+        char rev[4]; int rp = 0;
+        while (p > 0 && rp < 3) { rev[rp++] = '0' + (p % 10); p /= 10; }
+        while (rp--) pbuf[ppos++] = rev[rp];
+    }
+    pbuf[ppos] = 0; print(pbuf); print("%  ");
+    // MB
+    uint32_t mb_done = (done * 512) / (1024*1024);
+    uint32_t mb_total = (total * 512) / (1024*1024);
+    char nbuf[16]; int npos = 0;
+    if (mb_done == 0) nbuf[npos++] = '0';
+    else {
+        char revn[16]; int rn = 0;
+        while (mb_done > 0) { revn[rn++] = '0' + (mb_done % 10); mb_done /= 10; }
+        while (rn--) nbuf[npos++] = revn[rn];
+    }
+    nbuf[npos] = 0; print(nbuf);
+    print("MB/");
+    npos = 0;
+    if (mb_total == 0) nbuf[npos++] = '0';
+    else {
+        char revt[16]; int rt = 0;
+        while (mb_total > 0) { revt[rt++] = '0' + (mb_total % 10); mb_total /= 10; }
+        while (rt--) nbuf[npos++] = revt[rt];
+    }
+    nbuf[npos] = 0; print(nbuf); print("MB\n");
+}
+
+// Preload edilecek aralık: 2048'lik block'lar [first, end)
+struct ramdisk_preload {
+    uint32_t first;
+    uint32_t end;
+    int verbose;
+};
+
+// Aralığı ramdisk_pending'de işaretle; o andan itibaren kopyalanmamış
+// block'lar ilk erişimde cihazdan gelir
+static int ramdisk_preload_prepare(uint32_t start_lba, uint32_t sector_count, struct ramdisk_preload* pl) {
     if (!ramdisk_enabled) {
         print("FATAL: RAM disk not enabled! Skipping preload.\n");
-        return;
+        return -1;
     }
     if (sector_count == 0) {
         print("FATAL: sector_count is zero! Nothing to copy.\n");
-        return;
+        return -1;
     }
-    if (sector_count > ramdisk_total_sectors)
-        sector_count = ramdisk_total_sectors;
+    if (ramdisk_pending) return -1;     // Önceki preload sürüyor
+    if (start_lba >= ramdisk_total_sectors) return -1;
+    if (sector_count > ramdisk_total_sectors - start_lba)
+        sector_count = ramdisk_total_sectors - start_lba;
+
+    uint32_t blocks = (ramdisk_total_sectors + 3) / 4;
+    ramdisk_pending = (uint32_t*)kcalloc((blocks + 31) / 32, sizeof(uint32_t));
+    if (!ramdisk_pending) return -1;
+    pl->first = start_lba / 4;
+    pl->end = (start_lba + sector_count + 3) / 4;
+    for (uint32_t b = pl->first; b < pl->end; b++) ramdisk_pending[b / 32] |= 1u << (b % 32);
+    if (pl->first == 0) ramdisk_iso_sectors = 0;
+    return 0;
+}
 
-    struct fs_header header_snapshot;
-    {
-        char hdrbuf[4096];
-        uint8_t prev = ramdisk_enabled;
-        ramdisk_enabled = 0;
-        int hdr_ok = 1;
-        for (int i = 0; i < FS_SECTOR_COUNT; i++) {
-            if (disk_read_sector(FS_SECTOR_START + i, hdrbuf + i * 512) != 0) { hdr_ok = 0; break; }
+// Block'ları sırayla kopyala. Arka planda çalışırken her batch'ten sonra
+// shell'e (ya da daha öncelikli kime) sıra verir.
+static void ramdisk_preload_run(struct ramdisk_preload* pl) {
+    uint32_t total = pl->end - pl->first;
+    uint32_t last_shown_percent = 101;
+
+    #define BATCH_SIZE 16
+    for (uint32_t b = pl->first; b < pl->end; ) {
+        uint32_t batch_end = pl->end - b > BATCH_SIZE ? b + BATCH_SIZE : pl->end;
+        for (; b < batch_end; b++) ramdisk_fault(b * 4);
+
+        if (pl->first == 0) {
+            uint32_t copied = b * 4;
+            ramdisk_iso_sectors = copied < ramdisk_total_sectors ? copied : ramdisk_total_sectors;
         }
-        ramdisk_enabled = prev;
-        if (hdr_ok) {
-            for (int i = 0; i < sizeof(struct fs_header); i++) ((char*)&header_snapshot)[i] = hdrbuf[i];
+        if (pl->verbose) {
+            uint32_t percent = ((b - pl->first) * 100) / total;
+            if (percent >= last_shown_percent + 5 || b == pl->end) {
+                last_shown_percent = percent;
+                ramdisk_print_progress((b - pl->first) * 4, total * 4);
+            }
         } else {
-            for (int i = 0; i < sizeof(struct fs_header); i++) ((char*)&header_snapshot)[i] = 0;
+            process_cond_resched();
         }
     }
 
-    char tmp[512];
-    uint32_t total = sector_count;
-    uint32_t last_shown_percent = 101;
-    const uint32_t bar_width = 30;
-    uint32_t read_errors = 0;
-
-    print("Copying system image to RAM (read-only ISO -> RAM, RW enabled)\n");
+    kfree(ramdisk_pending);
+    ramdisk_pending = 0;
+    if (pl->verbose) {
+        print_color("RAM preload complete. Operating on RAM (no writes to ISO)\n", VGA_COLOR_LIGHT_GREEN);
+    }
+}
 
-    #define BATCH_SIZE 16
-    for (uint32_t i = 0; i < sector_count && (start_lba + i) < ramdisk_total_sectors; ) {
-        uint32_t batch_count = (BATCH_SIZE < (sector_count - i)) ? BATCH_SIZE : (sector_count - i);
-        if ((start_lba + i + batch_count) > ramdisk_total_sectors) {
-            batch_count = ramdisk_total_sectors - (start_lba + i);
-        }
+static void ramdisk_preload_work(void* arg) {
+    ramdisk_preload_run((struct ramdisk_preload*)arg);
+    kfree(arg);
+}
 
-        for (uint32_t j = 0; j < batch_count; j++) {
-            // Try ATAPI/DVD first if device is CD-ROM/DVD
-            int r = -1;
-            if (device_type == DEVICE_TYPE_ATAPI_CDROM || device_type == DEVICE_TYPE_ATAPI_DVD) {
-                char blk2048[2048];
-                uint32_t lba2048 = (start_lba + i + j) / 4;
-                uint32_t off = ((start_lba + i + j) % 4) * 512;
-                if (atapi_read_block_2048(lba2048, blk2048) == 0) {
-                    for (int b = 0; b < 512; b++) tmp[b] = blk2048[off + b];
-                    r = 0;
-                }
-            }
-            
-            // If ATAPI failed or not ATAPI device, try ATA
-            if (r != 0) {
-                uint8_t prev = ramdisk_enabled;
-                ramdisk_enabled = 0;
-                r = disk_read_sector(start_lba + i + j, tmp);
-                ramdisk_enabled = prev;
-            }
-            
-            if (r != 0) {
-                read_errors++;
-                // Zero fill on error instead of stopping
-                for (int b = 0; b < 512; b++) tmp[b] = 0;
-            } else {
-                read_errors = 0; // reset error counter on successful read
-            }
-            memcpy(ramdisk_buffer + ((start_lba + i + j) * 512), tmp, 512);
-        }
+void ramdisk_preload_from_lba(uint32_t start_lba, uint32_t sector_count) {
+    struct ramdisk_preload pl;
+    if (ramdisk_preload_prepare(start_lba, sector_count, &pl) < 0) return;
+    pl.verbose = 1;
+    print("Copying system image to RAM (read-only ISO -> RAM, RW enabled)\n");
+    ramdisk_preload_run(&pl);
+}
 
-        i += batch_count;
-
-        uint32_t done = i;
-        if (total == 0) total = 1; // avoid div by zero
-        uint32_t percent = (done * 100) / total;
-        if (percent >= last_shown_percent + 5 || done == total) {
-            last_shown_percent = percent;
-            char bar[31];
-            uint32_t filled = (percent * bar_width) / 100;
-            for (uint32_t j = 0; j < bar_width; j++) bar[j] = (j < filled) ? '#' : '-';
-            bar[bar_width] = '\0';
-
-            print("  ["); print(bar); print("] ");
-            // Percent
-            char pbuf[4]; int p = percent; int ppos = 0;
-            if (p == 0) pbuf[ppos++] = '0';
-            else {
-                char rev[4]; int rp = 0;
-                while (p > 0 && rp < 3) { rev[rp++] = '0' + (p % 10); p /= 10; }
-                while (rp--) pbuf[ppos++] = rev[rp];
-            }
-            pbuf[ppos] = 0; print(pbuf); print("%  ");
-            // MB
-            uint32_t mb_done = (done * 512) / (1024*1024);
-            uint32_t mb_total = (total * 512) / (1024*1024);
-            char nbuf[16]; int npos = 0;
-            if (mb_done == 0) nbuf[npos++] = '0';
-            else {
-                char revn[16]; int rn = 0;
-                while (mb_done > 0) { revn[rn++] = '0' + (mb_done % 10); mb_done /= 10; }
-                while (rn--) nbuf[npos++] = revn[rn];
-            }
-            nbuf[npos] = 0; print(nbuf);
-            print("MB/");
-            npos = 0;
-            if (mb_total == 0) nbuf[npos++] = '0';
-            else {
-                char revt[16]; int rt = 0;
-                while (mb_total > 0) { revt[rt++] = '0' + (mb_total % 10); mb_total /= 10; }
-                while (rt--) nbuf[npos++] = revt[rt];
-            }
-            nbuf[npos] = 0; print(nbuf); print("MB\n");
-        }
+// Preload'u bir worker'a ver, hemen dön. Bitene kadar kopyalanmamış
+// sektörler okunurken/yazılırken cihazdan alınır.
+void ramdisk_preload_async(uint32_t start_lba, uint32_t sector_count) {
+    struct ramdisk_preload* pl = (struct ramdisk_preload*)kmalloc(sizeof(struct ramdisk_preload));
+    if (!pl) {
+        ramdisk_preload_from_lba(start_lba, sector_count);
+        return;
+    }
+    if (ramdisk_preload_prepare(start_lba, sector_count, pl) < 0) {
+        kfree(pl);
+        return;
+    }
+    pl->verbose = 0;
+    print("Copying system image to RAM in the background\n");
+    if (queue_work(ramdisk_preload_work, pl) < 0) {
+        pl->verbose = 1;
+        ramdisk_preload_work(pl);
     }
+}
 
-    print_color("RAM preload complete. Operating on RAM (no writes to ISO)\n", VGA_COLOR_LIGHT_GREEN);
+// Page cache'in ISO cihazı: 4KB sayfa = iki ISO block'u. Ramdisk'e kopyalanmış
+// kısım (TinyFS'in üstüne yazdığı sektörler hariç) kopyalanmadan verilir,
+// gerisi cihazdan okunur.
+static const uint8_t* iso_fill_page(uint32_t block, uint8_t* page) {
+    uint32_t first = block * 8;
+    uint32_t last = first + 8;
+    if (ramdisk_enabled && last <= ramdisk_iso_sectors &&
+        (last <= FS_SECTOR_START || first >= FS_SECTOR_START + FS_SECTOR_COUNT)) {
+        return ramdisk_buffer + first * 512;
+    }
+    if (!page) return 0;
+    if (iso_read_device_block2048(block * 2, (char*)page) != 0) return 0;
+    // ISO tek sayıda block'la bitiyorsa ikinci yarı sıfır
+    if (iso_read_device_block2048(block * 2 + 1, (char*)page + ATAPI_SECTOR_SIZE) != 0) {
+        for (int i = 0; i < ATAPI_SECTOR_SIZE; i++) page[ATAPI_SECTOR_SIZE + i] = 0;
+    }
+    return page;
 }
 
 void fs_init() {
+    pagecache_register(PAGECACHE_DEV_ISO, iso_fill_page);
     ramdisk_init_auto();
     if (!ramdisk_enabled) {
         print("Trying fallback 4MB RAM disk...\n");
@@ -925,13 +951,13 @@ void fs_init() {
     }
     sbuf[pos] = 0; print(sbuf); print("\n");
 
-    ramdisk_preload_from_lba(0, clone_sectors);
+    ramdisk_preload_async(0, clone_sectors);
 
     if (fs_disk_test() != 0) {
         print("Disk I/O test failed (expected on read-only ISO).\n");
     }
     
-    print_color("System ready (ISO preloaded to RAM)\n", VGA_COLOR_LIGHT_GREEN);
+    print_color("System ready (ISO preloading to RAM in the background)\n", VGA_COLOR_LIGHT_GREEN);
 }
 
 
@@ -1010,11 +1036,22 @@ int fs_read_file(char* path, char* buffer, uint32_t max_size) {
             }
         }
     }
-    // Fallback to ISO data in RAM
+    // Fallback to ISO data, page cache'ten doğrudan caller'ın buffer'ına
     iso_extent e; int isdir=0; if (iso_lookup_path(path, &e, &isdir)!=0 || isdir) return -1;
     uint32_t remaining = e.size; if (remaining > max_size) remaining = max_size;
     uint32_t blocks = (remaining + 2047) / 2048; uint32_t copied=0;
-    for (uint32_t b=0;b<blocks;b++) { char blk[2048]; if (iso_read_block2048(e.lba + b, blk)!=0) break; uint32_t tocpy = (remaining - copied > 2048) ? 2048 : (remaining - copied); for (uint32_t i=0;i<tocpy;i++) buffer[copied+i]=blk[i]; copied += tocpy; }
+    for (uint32_t b=0;b<blocks;b++) {
+        uint32_t tocpy = (remaining - copied > 2048) ? 2048 : (remaining - copied);
+        const uint8_t* blk = iso_block(e.lba + b);
+        char tmp[2048];
+        if (!blk) {
+            // Cache dolu/okunamadı: doğrudan cihazdan
+            if (iso_read_device_block2048(e.lba + b, tmp) != 0) break;
+            blk = (const uint8_t*)tmp;
+        }
+        memcpy(buffer + copied, blk, tocpy);
+        copied += tocpy;
+    }
     return copied>0 ? (int)copied : -1;
 }
 
@@ -1039,6 +1076,53 @@ int fs_get_file_size(char* path) {
     return -1;
 }
 
+// ISO dosyasının ramdisk'teki kopyasını doğrudan ver (program yükleyicisi
+// sayfaları buradan eşliyor). TinyFS'teki dosyalar, ramdisk'e tamamı
+// kopyalanmamış ya da TinyFS header sektörlerine değen extent'ler için -1.
+int fs_file_extent(char* path, const uint8_t** data, uint32_t* size) {
+    if (!ramdisk_enabled || !ramdisk_iso_sectors) return -1;
+
+    struct fs_header header;
+    if (fs_read_header(&header) == 0 && header.magic == FS_MAGIC) {
+        for (int i = 0; i < MAX_FILES; i++) {
+            if (header.files[i].used && strcmp(header.files[i].path, path) == 0) return -1;
+        }
+    }
+
+    iso_extent e;
+    int isdir = 0;
+    if (iso_lookup_path(path, &e, &isdir) != 0 || isdir) return -1;
+
+    uint32_t first = e.lba * 4;
+    uint32_t last = first + (e.size + 511) / 512;
+    if (last > ramdisk_iso_sectors || last < first) return -1;
+    if (first < FS_SECTOR_START + FS_SECTOR_COUNT && last > FS_SECTOR_START) return -1;
+
+    *data = ramdisk_buffer + first * 512;
+    *size = e.size;
+    return 0;
+}
+
+// ISO dosyasının page cache'teki yeri: cihaz ve cihaz başından byte offset'i.
+// Ramdisk'te olsun olmasın bütün ISO dosyaları için; TinyFS dosyaları -1.
+int fs_file_cache_extent(char* path, uint32_t* dev, uint32_t* offset, uint32_t* size) {
+    struct fs_header header;
+    if (fs_read_header(&header) == 0 && header.magic == FS_MAGIC) {
+        for (int i = 0; i < MAX_FILES; i++) {
+            if (header.files[i].used && strcmp(header.files[i].path, path) == 0) return -1;
+        }
+    }
+
+    iso_extent e;
+    int isdir = 0;
+    if (iso_lookup_path(path, &e, &isdir) != 0 || isdir) return -1;
+
+    *dev = PAGECACHE_DEV_ISO;
+    *offset = e.lba * ATAPI_SECTOR_SIZE;
+    *size = e.size;
+    return 0;
+}
+
 int fs_write_file(char* name, char* data, uint32_t size) {
     fs_delete_file(name, 0);
     return fs_create_file(name, data, size);
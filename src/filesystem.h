@@ -37,6 +37,8 @@ int fs_create_file(char* name, char* data, uint32_t size);
 int fs_create_directory(char* path);
 int fs_read_file(char* name, char* buffer, uint32_t max_size);
 int fs_get_file_size(char* path);
+int fs_file_extent(char* path, const uint8_t** data, uint32_t* size);
+int fs_file_cache_extent(char* path, uint32_t* dev, uint32_t* offset, uint32_t* size);
 int fs_write_file(char* name, char* data, uint32_t size);
 int fs_delete_file(const char* path, int recursive);
 void fs_list_files(char* current_path);
@@ -55,5 +57,6 @@ int disk_write_sector(uint32_t lba, char* buffer);
 void ramdisk_init(uint32_t total_sectors);
 void ramdisk_init_auto();
 void ramdisk_preload_from_lba(uint32_t start_lba, uint32_t sector_count);
+void ramdisk_preload_async(uint32_t start_lba, uint32_t sector_count);
 
 #endif
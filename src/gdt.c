@@ -49,10 +49,13 @@ struct tss_entry {
     uint16_t iomap_base;
 } __attribute__((packed));
 
-// GDT with 6 entries: null, kernel code, kernel data, user code, user data, TSS
-struct gdt_entry gdt[6];
+// GDT with 7 entries: null, kernel code, kernel data, user code, user data, TSS,
+// double fault TSS
+struct gdt_entry gdt[7];
 struct gdt_ptr gp;
 struct tss_entry tss;
+struct tss_entry df_tss;
+static uint8_t df_stack[8192];
 
 extern void gdt_flush(uint32_t);
 extern void tss_flush();
@@ -86,8 +89,36 @@ void tss_init(uint32_t idx, uint32_t kss, uint32_t kesp) {
     gdt_set_gate(idx, base, limit, 0x89, 0x00);
 }
 
+// Double fault ayrı bir task'ta (task gate) çalışır: kernel stack'i guard
+// sayfasına taşınca CPU exception frame'ini o stack'e yazamaz, kendi
+// stack'i olmayan bir handler triple fault'a (reset) döner. cr3 paging
+// kurulduktan sonra bilindiği için gdt_init'ten ayrı.
+void tss_init_double_fault(uint32_t idx, uint32_t cr3, void (*entry)()) {
+    for (int i = 0; i < sizeof(df_tss); i++) {
+        ((uint8_t*)&df_tss)[i] = 0;
+    }
+    df_tss.cr3 = cr3;
+    df_tss.eip = (uint32_t)entry;
+    df_tss.eflags = 0x002;      // IF kapalı
+    df_tss.esp = (uint32_t)(df_stack + sizeof(df_stack));
+    df_tss.cs = 0x08;
+    df_tss.ss = 0x10;
+    df_tss.ds = 0x10;
+    df_tss.es = 0x10;
+    df_tss.fs = 0x10;
+    df_tss.gs = 0x10;
+    df_tss.iomap_base = sizeof(df_tss);
+    gdt_set_gate(idx, (uint32_t)&df_tss, sizeof(df_tss), 0x89, 0x00);
+}
+
+// Double fault'ta kesilen kodun eip/esp'si: task switch onları ana TSS'e yazar
+void tss_fault_context(uint32_t* eip, uint32_t* esp) {
+    *eip = tss.eip;
+    *esp = tss.esp;
+}
+
 void gdt_init() {
-    gp.limit = (sizeof(struct gdt_entry) * 6) - 1;
+    gp.limit = (sizeof(struct gdt_entry) * 7) - 1;
     gp.base = (uint32_t)&gdt;
     
     // Null descriptor
@@ -108,7 +139,7 @@ void gdt_init() {
     // TSS (0x28)
     // We need a kernel stack - use a reasonable address
     // This should be set to your kernel stack top
-    tss_init(5, 0x10, 0x00090000);  // Kernel data segment, stack at 0x90000
+    tss_init(5, 0x10, 0xC0090000);  // Kernel data segment, stack at phys 0x90000 (higher half)
     
     // Load the GDT
     gdt_flush((uint32_t)&gp);
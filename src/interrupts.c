@@ -1,6 +1,10 @@
 #include "interrupts.h"
 #include "vga.h"
 #include "syscall.h"
+#include "paging.h"
+#include "process.h"
+#include "pmm.h"
+#include "z_utils.h"
 
 #define IDT_ENTRIES 256
 #define PIC1_COMMAND 0x20
@@ -96,6 +100,33 @@ void interrupts_init() {
     __asm__ volatile("sti");
 }
 
+// Double fault task'ı: kendi stack'inde, interrupt'lar kapalı. esp kesilen
+// process'in kernel stack'inin guard sayfasına inmişse stack taşmıştır.
+// Dönülecek sağlam bir durum yok.
+static void double_fault_task() {
+    extern void tss_fault_context(uint32_t* eip, uint32_t* esp);
+    uint32_t eip, esp;
+    tss_fault_context(&eip, &esp);
+
+    struct process* p = current_process;
+    if (p && p->stack && esp >= p->stack - PAGE_SIZE && esp < p->stack + PAGE_SIZE) {
+        z_printf("\nKernel stack overflow in %s (pid %u, eip 0x%x, esp 0x%x)\n",
+                 p->name, p->pid, eip, esp);
+    } else {
+        z_printf("\nDouble fault (eip 0x%x, esp 0x%x)\n", eip, esp);
+    }
+    z_printf("System halted\n");
+    while (1) { __asm__ volatile("cli; hlt"); }
+}
+
+// Paging kurulduktan sonra: vector 8 isr8 yerine task gate ile GDT 6'daki
+// (0x30) TSS'e geçer
+void interrupts_init_double_fault() {
+    extern void tss_init_double_fault(uint32_t idx, uint32_t cr3, void (*entry)());
+    tss_init_double_fault(6, V2P(paging_kernel_directory()), double_fault_task);
+    idt_set_gate(8, 0, 0x30, 0x85);
+}
+
 void pic_send_eoi(uint8_t irq) {
     if (irq >= 8) {
         // PIC2'ye EOI gönder
@@ -110,82 +141,52 @@ extern uint32_t saved_kernel_esp;
 extern uint32_t saved_kernel_ebp;
 extern int program_exit_requested;
 
+// iret, elf_exit_handler_asm'e döner; o da elf_load_and_run'ın kaydettiği
+// kernel stack'ine atlar. Program kernel'e girmiş olmalı (syscall ya da IRQ).
+void program_exit_frame(struct regs* r) {
+    extern void elf_exit_handler_asm();
+    extern uint32_t saved_kernel_esp_for_exit;
+    extern uint32_t saved_kernel_ebp_for_exit;
+    if (saved_kernel_esp == 0 || saved_kernel_ebp == 0) return;
+
+    // iret, stub'ın stack'e koyduğu frame'deki EIP'e döner
+    r->eip = (uint32_t)elf_exit_handler_asm;
+
+    // Save kernel stack values for exit handler
+    saved_kernel_esp_for_exit = saved_kernel_esp;
+    saved_kernel_ebp_for_exit = saved_kernel_ebp;
+
+    // Clear saved pointers
+    saved_kernel_esp = 0;
+    saved_kernel_ebp = 0;
+    program_exit_requested = 0;
+}
+
 // ISR handler
 void isr_handler(struct regs* r) {
-    // Debug: Print MY BALLSACKS CURRENT STATUS
     if (r->int_no == 128) {
-        // CRITICAL: Print immediately to verify int 0x80 is firing
-        print_color("\n!!! SYSCALL FIRED !!! eax=", VGA_COLOR_LIGHT_GREEN);
-        // Print eax value
-        char eax_hex[16];
-        int eax_pos = 0;
-        uint32_t eax_val = r->eax;
-        for (int i = 7; i >= 0; i--) {
-            uint8_t nibble = (eax_val >> (i * 4)) & 0xF;
-            eax_hex[eax_pos++] = (nibble < 10) ? ('0' + nibble) : ('a' + nibble - 10);
-        }
-        eax_hex[eax_pos] = '\0';
-        print(eax_hex);
-        print("]\n");
-        
         // Linux syscall (int 0x80)
         // Linux syscall convention: eax = syscall number, ebx, ecx, edx, esi, edi, ebp = args
+        syscall_frame = r;
         int32_t result = handle_syscall(r->eax, r->ebx, r->ecx, r->edx, r->esi, r->edi, r->ebp);
         r->eax = result;  // Return value in eax
         
+        // Bekleyen sinyal (kill, SIGALRM) process'i sonlandırır
+        process_check_signal(r);
+        
         // Check if program requested exit
-        if (program_exit_requested && saved_kernel_esp != 0 && saved_kernel_ebp != 0) {
-            extern void elf_exit_handler_asm();
-            extern uint32_t saved_kernel_esp_for_exit;
-            extern uint32_t saved_kernel_ebp_for_exit;
-            
-            print_color("[EXIT REQUESTED] Modifying return EIP\n", VGA_COLOR_LIGHT_GREEN);
-            
-            // Use inline assembly to directly access the stack and modify EIP
-            // The stack when isr_handler is called has the EIP pushed by int 0x80
-            // We need to find it relative to the regs struct pointer
-            // Stack: [call ret][int_no][err][ds][edi][esi][ebp][esp][ebx][edx][ecx][eax][EIP][CS][EFLAGS]
-            // r points to edi, so EIP is at r - 44 bytes (8 regs before edi + ds + err + int_no + call_ret)
-            uint32_t old_eip;
-            __asm__ volatile(
-                "mov %1, %%eax\n\t"      // Get pointer to regs struct
-                "sub $44, %%eax\n\t"     // Go back 44 bytes to find EIP
-                "mov (%%eax), %%ebx\n\t" // Read old EIP
-                "mov %%ebx, %0\n\t"     // Store in old_eip
-                "mov %2, %%ecx\n\t"     // Get exit handler address
-                "mov %%ecx, (%%eax)"    // Write new EIP
-                : "=r"(old_eip)
-                : "r"((uint32_t)r), "r"((uint32_t)elf_exit_handler_asm)
-                : "eax", "ebx", "ecx", "memory"
-            );
-            
-            print_color("[EXIT] Old EIP: 0x", VGA_COLOR_LIGHT_GREEN);
-            // Print old EIP
-            char eip_hex[16];
-            int eip_pos = 0;
-            for (int i = 7; i >= 0; i--) {
-                uint8_t nibble = (old_eip >> (i * 4)) & 0xF;
-                eip_hex[eip_pos++] = (nibble < 10) ? ('0' + nibble) : ('a' + nibble - 10);
-            }
-            eip_hex[eip_pos] = '\0';
-            print(eip_hex);
-            print("\n");
-            
-            // Save kernel stack values for exit handler
-            saved_kernel_esp_for_exit = saved_kernel_esp;
-            saved_kernel_ebp_for_exit = saved_kernel_ebp;
-            
-            // Clear saved pointers
-            saved_kernel_esp = 0;
-            saved_kernel_ebp = 0;
-            program_exit_requested = 0;
-            
-            print_color("[EXIT] EIP modified, stack will be restored on iret\n", VGA_COLOR_LIGHT_GREEN);
+        if (program_exit_requested) {
+            program_exit_frame(r);
         }
         
         return;
     }
     
+    // Page fault: paging çözebiliyorsa (ileride COW/demand fill) kaldığı yerden devam
+    if (r->int_no == 14 && paging_fault(r)) {
+        return;
+    }
+    
     // Debug: Print ANY interrupt during program execution (including faults)
     extern void* elf_exit_label_addr;
     if (elf_exit_label_addr != 0 && r->int_no != 128) {
@@ -248,14 +249,13 @@ void isr_handler(struct regs* r) {
         saved_kernel_esp = 0;
         saved_kernel_ebp = 0;
         
-        uint32_t* eip_ptr = (uint32_t*)((uint32_t)r - 12);
-        *eip_ptr = (uint32_t)elf_fault_recovery;
+        r->eip = (uint32_t)elf_fault_recovery;
         
         return;
     }
     
     // Basit interrupt handler - sadece ekrana yazdır
-    uint16_t* vga = (uint16_t*)0xB8000;
+    uint16_t* vga = (uint16_t*)P2V(0xB8000);
     vga[80] = 0x0F49; // I
     vga[81] = 0x0F4E; // N
     vga[82] = 0x0F54; // T
@@ -7,12 +7,14 @@ typedef unsigned short uint16_t;
 typedef unsigned int uint32_t;
 
 // Register yapısı (ISR/IRQ handler için)
-// Assembly'de pushlanan sırayla: pusha + ds + int_no + err_code
+// Stack'teki sırayla: ds + pusha + int_no + err_code + CPU'nun pushladığı frame
 struct regs {
+    uint32_t ds;
     uint32_t edi, esi, ebp, esp;
     uint32_t ebx, edx, ecx, eax;
-    uint32_t ds;
     uint32_t int_no, err_code;
+    uint32_t eip, cs, eflags;
+    uint32_t useresp, ss;   // Sadece ring değişiminde geçerli
 };
 
 // Interrupt descriptor table entry
@@ -32,12 +34,17 @@ struct idt_ptr {
 
 // Interrupt handler fonksiyonları
 void interrupts_init();
+void interrupts_init_double_fault();
 void idt_set_gate(uint8_t num, uint32_t base, uint16_t sel, uint8_t flags);
 
 // PIC (Programmable Interrupt Controller) fonksiyonları
 void pic_init();
 void pic_send_eoi(uint8_t irq);
 
+// Shell'in çalıştırdığı programı bitir (iret kernel'e döner)
+struct regs;
+void program_exit_frame(struct regs* r);
+
 // Interrupt handler'lar
 extern void isr0();
 extern void isr1();
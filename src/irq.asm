@@ -1,299 +1,36 @@
 ; IRQ (Interrupt Request) handlers
-; Her IRQ için ayrı stub, ISR'lar ile aynı stack layout
+; ISR'lar ile aynı stack layout, ortak gövde irq_handler'a struct regs* verir
 
 global irq0, irq1, irq2, irq3, irq4, irq5, irq6, irq7
 global irq8, irq9, irq10, irq11, irq12, irq13, irq14, irq15
 
 extern irq_handler
 
-irq0:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 32
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq1:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 33
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq2:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 34
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq3:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 35
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq4:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 36
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq5:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 37
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq6:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 38
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq7:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 39
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq8:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 40
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq9:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 41
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq10:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 42
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq11:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 43
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
+%macro IRQ 2
+irq%1:
+    push dword 0
+    push dword %2
+    jmp irq_common_stub
+%endmacro
 
-irq12:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 44
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
+IRQ 0, 32
+IRQ 1, 33
+IRQ 2, 34
+IRQ 3, 35
+IRQ 4, 36
+IRQ 5, 37
+IRQ 6, 38
+IRQ 7, 39
+IRQ 8, 40
+IRQ 9, 41
+IRQ 10, 42
+IRQ 11, 43
+IRQ 12, 44
+IRQ 13, 45
+IRQ 14, 46
+IRQ 15, 47
 
-irq13:
-    cli
+irq_common_stub:
     pusha
     mov ax, ds
     push eax
@@ -302,58 +39,14 @@ irq13:
     mov es, ax
     mov fs, ax
     mov gs, ax
-    push 0
-    push 45
+    push esp                ; struct regs*
     call irq_handler
-    add esp, 8
+    add esp, 4
     pop eax
     mov ds, ax
     mov es, ax
     mov fs, ax
     mov gs, ax
     popa
+    add esp, 8              ; int_no ve err_code
     iret
-
-irq14:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 46
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret
-
-irq15:
-    cli
-    pusha
-    mov ax, ds
-    push eax
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    push 0
-    push 47
-    call irq_handler
-    add esp, 8
-    pop eax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
-    popa
-    iret 
\ No newline at end of file
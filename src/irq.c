@@ -1,5 +1,7 @@
 #include "interrupts.h"
 #include "keyboard.h"
+#include "timer.h"
+#include "process.h"
 
 // IRQ handler fonksiyonları
 extern void irq0(), irq1(), irq2(), irq3(), irq4(), irq5(), irq6(), irq7();
@@ -9,16 +11,23 @@ void irq_handler(struct regs* r) {
     // IRQ numarasını al
     uint8_t irq_no = r->int_no - 32;
     
-    // Keyboard interrupt (IRQ 1)
-    if (irq_no == 1) {
-        keyboard_handler();
-    }
-    
-    // EOI gönder
+    // EOI önce gönderilir: timer başka process'e geçerse bu handler'a
+    // o process tekrar seçilene kadar dönülmez
     if (irq_no >= 8) {
         __asm__ volatile("outb %%al, %%dx" : : "a"(0x20), "d"(0xA0));
     }
     __asm__ volatile("outb %%al, %%dx" : : "a"(0x20), "d"(0x20));
+    
+    // Timer interrupt (IRQ 0)
+    if (irq_no == 0) {
+        timer_irq();
+        process_tick(r);
+    }
+    
+    // Keyboard interrupt (IRQ 1)
+    if (irq_no == 1) {
+        keyboard_handler();
+    }
 }
 
 void irq_init() {
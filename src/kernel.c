@@ -17,6 +17,12 @@ typedef unsigned int uint32_t;
 #include "vga.h"
 #include "banner.h"
 #include "syscall.h"
+#include "pmm.h"
+#include "paging.h"
+#include "z_utils.h"
+#include "timer.h"
+#include "vdso.h"
+#include "workqueue.h"
 
 // Multiboot2 header (sadece multiboot için, framebuffer yok)
 #define MULTIBOOT2_HEADER_MAGIC 0xE85250D6
@@ -43,15 +49,19 @@ int rand100() {
     return (fake_rand % 100);
 }
 
+// Boot mesajları arası bekleme: CPU timer'a kadar durur
 void delay(int ms) {
-    for (volatile int i = 0; i < ms * 7000; i++) {
-        __asm__ volatile("nop");
-    }
+    process_msleep((uint32_t)ms);
 }
 
 void kernel_main(uint32_t mb_magic, uint32_t mb_addr) {
     gdt_init();
     interrupts_init();
+    irq_init();
+    paging_init();
+    interrupts_init_double_fault();
+    // Timer (IRQ0) erken kurulur: boot'taki delay'ler onun üstünde uyur
+    timer_init();
     vga_init(mb_magic, mb_addr);
     clear_screen();
     print_color("\n   KuzuOS 1.0 (C) 2025\n", VGA_COLOR_CYAN);
@@ -67,12 +77,22 @@ void kernel_main(uint32_t mb_magic, uint32_t mb_addr) {
     print_color("SSE2, MMX, FPU, VME\n", VGA_COLOR_LIGHT_GREY);
     delay(350);
 
-    print("[ "); print_color("..", VGA_COLOR_YELLOW); print(" ] RAM check:            "); delay(350);
-    print_color("2048 MB detected\n", VGA_COLOR_LIGHT_GREEN);
+    // memory_init pmm'i multiboot memory map'inden kurar, RAM miktarı oradan gelir
+    print("[ "); print_color("..", VGA_COLOR_YELLOW); print(" ] RAM check:            "); memory_init(); delay(350);
+    struct pmm_stats mem_stats;
+    pmm_get_stats(&mem_stats);
+    z_printf("%u MB usable, largest free block %u KB\n",
+             mem_stats.total_pages / (1024 * 1024 / PAGE_SIZE),
+             mem_stats.largest_order < 0 ? 0 : (PAGE_SIZE / 1024) << mem_stats.largest_order);
     delay(500);
 
-    print("[ "); print_color("..", VGA_COLOR_YELLOW); print(" ] Memory manager:       "); memory_init(); delay(400);
-    print_color("OK\n", VGA_COLOR_LIGHT_GREEN); delay(600);
+    print("[ "); print_color("..", VGA_COLOR_YELLOW); print(" ] Memory manager:       "); delay(400);
+    print_color("OK, paging on (4MB pages)\n", VGA_COLOR_LIGHT_GREEN); delay(600);
+
+    // Scheduler ve worker thread'ler fs_init'ten önce: ISO preload arka
+    // planda sürer, boot'un geri kalanı ve shell onu beklemez
+    process_init();
+    workqueue_init();
 
     // Initialize filesystem (RAM overlay + tiny FS)
     fs_init();
@@ -80,6 +100,10 @@ void kernel_main(uint32_t mb_magic, uint32_t mb_addr) {
     // Initialize syscall system
     syscall_init();
 
+    // vDSO sayfası (timer bir sonraki tick'te doldurur), klavye (IRQ1)
+    vdso_init();
+    keyboard_init();
+
     print("[ "); print_color("..", VGA_COLOR_YELLOW); print(" ] PCI bus scan:         "); delay(400);
     print_color("2 devices found\n", VGA_COLOR_LIGHT_GREEN); delay(500);
 
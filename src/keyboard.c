@@ -1,5 +1,6 @@
 #include "keyboard.h"
 #include "vga.h"
+#include "process.h"
 
 #define KEYBOARD_DATA_PORT 0x60
 
@@ -15,11 +16,12 @@ static const char scancode_to_ascii[128] = {
 static const char shift_chars[] = "!@#$%^&*()";
 
 static char keyboard_buffer[KEYBOARD_BUFFER_SIZE];
-static int buffer_head = 0;
-static int buffer_tail = 0;
+static volatile int buffer_head = 0;   // IRQ1 yazar
+static volatile int buffer_tail = 0;
 static int shift = 0;
 static int caps_lock = 0;
 static int e0_prefix = 0;
+static struct wait_queue keyboard_wq;      // keyboard_wait'te uyuyan shell
 
 void keyboard_init() {
     buffer_head = 0;
@@ -28,20 +30,29 @@ void keyboard_init() {
     caps_lock = 0;
     e0_prefix = 0;
     
-    // PIC'te IRQ1'i devre dışı bırak - polling kullanacağız
+    // PIC'te IRQ1'i aç: tuşlar interrupt ile gelir, boştaki CPU'yu uyandırır
     uint8_t mask;
     __asm__ volatile("inb $0x21, %0" : "=a"(mask));
-    mask |= 0x02; // IRQ1'i devre dışı bırak
+    mask &= ~0x02;
     __asm__ volatile("outb %0, $0x21" : : "a"(mask));
 }
 
+// IRQ1: controller'daki byte'ı buffer'a al, tuş bekleyeni uyandır
 void keyboard_handler() {
-    // why 
-    return;
+    keyboard_poll();
+    if (buffer_head != buffer_tail) process_wake_queue(&keyboard_wq);
 }
 
-// Polling ile keyboard oku
-void keyboard_poll() {
+// Tuş yoksa tuş gelene (ya da bir interrupt'a) kadar uyu; CPU bu arada
+// kernel thread'lere geçer, kimse yoksa durur
+void keyboard_wait() {
+    __asm__ volatile("cli");
+    if (buffer_head == buffer_tail) process_wait_event(&keyboard_wq);
+    __asm__ volatile("sti");
+}
+
+// Controller'da byte varsa al, tuşa çevirip buffer'a koy
+static void keyboard_read_byte() {
     uint8_t status;
     __asm__ volatile("inb $0x64, %0" : "=a"(status));
     
@@ -131,6 +142,15 @@ void keyboard_poll() {
     }
 }
 
+// Polling ile keyboard oku; IRQ1 aynı byte'ı ikinci kez okumasın diye
+// interrupt'lar kapalı
+void keyboard_poll() {
+    uint32_t flags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(flags) :: "memory");
+    keyboard_read_byte();
+    if (flags & 0x200) __asm__ volatile("sti" ::: "memory");
+}
+
 char keyboard_get_char() {
     if (buffer_head == buffer_tail) return 0;
     char c = keyboard_buffer[buffer_tail];
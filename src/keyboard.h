@@ -10,6 +10,7 @@ typedef unsigned int   uint32_t;
 void keyboard_init();
 void keyboard_handler();
 void keyboard_poll();
+void keyboard_wait();
 char keyboard_get_char();
 
 #endif 
\ No newline at end of file
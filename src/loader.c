@@ -8,6 +8,8 @@ extern void* kmalloc(uint32_t size);
 extern void kfree(void* ptr);
 extern int fs_read_file(char* name, char* buffer, uint32_t max_size);
 extern void putchar(char c);
+extern int z_map_segment(void *addr, size_t size, int prot, int fd, off_t offset, size_t filesz);
+extern void z_set_brk(unsigned long start);
 
 #define NULL ((void*)0)
 
@@ -35,12 +37,15 @@ static int check_ehdr(Elf_Ehdr *ehdr)
                 (ehdr->e_type != ET_EXEC && ehdr->e_type != ET_DYN)) ? 0 : 1;
 }
 
-// Kernel space version - direct memory writes, no mmap
+// Segmentler kendi p_vaddr'larına, process'in page directory'sine eşlenir
+// (z_map_segment). ET_EXEC için bias 0; ET_DYN için boş bir user aralığı
+// seçilir ve bias = seçilen adres - minva. Dönen değer bu bias.
 static unsigned long loadelf_anon(int fd, Elf_Ehdr *ehdr, Elf_Phdr *phdr)
 {
-        unsigned long minva, maxva, size;
+        unsigned long minva, maxva, size, bias;
         Elf_Phdr *iter;
-        unsigned char *p, *base = 0;
+        unsigned char *base;
+        int dyn = ehdr->e_type == ET_DYN;
 
         minva = (unsigned long)-1;
         maxva = 0;
@@ -59,59 +64,48 @@ static unsigned long loadelf_anon(int fd, Elf_Ehdr *ehdr, Elf_Phdr *phdr)
         maxva = ROUND_PG(maxva);
         size = maxva - minva;
 
-        // ALWAYS allocate memory for the ELF, regardless of static/dynamic
-        base = (unsigned char *)kmalloc(size);
-        if (!base) {
-                z_printf("ERROR: kmalloc failed for size %x\n", (unsigned int)size);
+        // Check that we can hold the whole image (PROT_NONE sadece yer arar)
+        base = z_mmap(dyn ? NULL : (void *)minva, size, PROT_NONE,
+                      (dyn ? 0 : MAP_FIXED) | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == (void *)-1) {
+                z_printf("ERROR: no room for ELF at %x size %x\n",
+                         (unsigned int)minva, (unsigned int)size);
                 goto err;
         }
-        
-        z_printf("DEBUG: Allocated %x bytes at base %x for ELF (minva=%x maxva=%x)\n",
-                 (unsigned int)size, (unsigned int)base, 
-                 (unsigned int)minva, (unsigned int)maxva);
+        bias = (unsigned long)base - minva;
 
-        // Zero the entire allocation
-        z_memset(base, 0, size);
+        z_printf("DEBUG: Mapping ELF %x-%x (bias=%x)\n",
+                 (unsigned int)(minva + bias), (unsigned int)(maxva + bias),
+                 (unsigned int)bias);
 
-        // Load each segment
+        // Now map each segment separately in precalculated address.
+        // Pages past p_filesz read as zero, so .bss needs no memset.
         for (iter = phdr; iter < &phdr[ehdr->e_phnum]; iter++) {
-                unsigned long off, offset_in_base;
+                unsigned long off, start;
                 if (iter->p_type != PT_LOAD)
                         continue;
-                
+
                 off = iter->p_vaddr & ALIGN;
-                // Calculate where in our allocated buffer this segment goes
-                offset_in_base = TRUNC_PG(iter->p_vaddr) - minva;
-                
-                p = base + offset_in_base;
-                
-                z_printf("DEBUG: Loading segment vaddr=%x filesz=%x memsz=%x to %x\n",
+                start = bias + TRUNC_PG(iter->p_vaddr);
+
+                z_printf("DEBUG: Loading segment vaddr=%x filesz=%x memsz=%x\n",
                          (unsigned int)iter->p_vaddr,
                          (unsigned int)iter->p_filesz,
-                         (unsigned int)iter->p_memsz,
-                         (unsigned int)(p + off));
-                
-                if (z_lseek(fd, iter->p_offset, SEEK_SET) < 0) {
-                        z_printf("ERROR: lseek failed\n");
-                        goto err_free;
-                }
-                if (z_read(fd, p + off, iter->p_filesz) != (ssize_t)iter->p_filesz) {
-                        z_printf("ERROR: read failed\n");
-                        goto err_free;
-                }
-                
-                // Zero BSS
-                if (iter->p_memsz > iter->p_filesz) {
-                        z_memset(p + off + iter->p_filesz, 0,
-                                 iter->p_memsz - iter->p_filesz);
+                         (unsigned int)iter->p_memsz);
+
+                // Sayfalar ilk erişimde dosyadan doldurulur (demand paging)
+                if (z_map_segment((void *)(start + off), iter->p_memsz,
+                                  PFLAGS(iter->p_flags), fd, iter->p_offset,
+                                  iter->p_filesz) < 0) {
+                        z_printf("ERROR: can't map segment at %x\n", (unsigned int)start);
+                        goto err_unmap;
                 }
         }
 
-        // Return just the base address (NOT adjusted)
-        return (unsigned long)base;
+        return bias;
 
-err_free:
-        kfree(base);
+err_unmap:
+        z_munmap((void *)(minva + bias), size);
 err:
         return LOAD_ERR;
 }
@@ -125,7 +119,7 @@ void z_entry(unsigned long *sp, void (*fini)(void))
         Elf_Phdr *phdr, *iter;
         Elf_auxv_t *av;
         char **argv, **env, **p, *elf_interp = NULL;
-        unsigned long base[2], entry[2];
+        unsigned long base[2], entry[2], phdr_addr = 0;
         const char *file;
         ssize_t sz;
         int argc, fd, i;
@@ -169,22 +163,27 @@ void z_entry(unsigned long *sp, void (*fini)(void))
                 if ((base[i] = loadelf_anon(fd, ehdr, phdr)) == LOAD_ERR)
                         z_errx(1, "can't load ELF %s", file);
 
-                /* Calculate entry point
-                 * base[i] is the allocated base
-                 * We need to find minva and calculate: entry = base + (e_entry - minva)
-                 */
-                unsigned long minva_for_entry = (unsigned long)-1;
-                for (Elf_Phdr *it = phdr; it < &phdr[ehdr->e_phnum]; it++) {
-                        if (it->p_type == PT_LOAD && it->p_vaddr < minva_for_entry) {
-                                minva_for_entry = it->p_vaddr;
+                /* Segmentler link adreslerinde; ET_DYN için bias eklenir */
+                entry[i] = base[i] + ehdr->e_entry;
+
+                /* Program header'ları dosyanın başını taşıyan segmentte */
+                if (i == Z_PROG) {
+                        unsigned long brk = 0;
+                        for (iter = phdr; iter < &phdr[ehdr->e_phnum]; iter++) {
+                                if (iter->p_type != PT_LOAD)
+                                        continue;
+                                if (iter->p_offset == 0 && !phdr_addr)
+                                        phdr_addr = base[i] + iter->p_vaddr + ehdr->e_phoff;
+                                if (iter->p_vaddr + iter->p_memsz > brk)
+                                        brk = iter->p_vaddr + iter->p_memsz;
                         }
+                        /* Heap programın (interp'in değil) .bss'inin arkasında */
+                        z_set_brk(base[i] + brk);
                 }
-                minva_for_entry = TRUNC_PG(minva_for_entry);
-                entry[i] = base[i] + (ehdr->e_entry - minva_for_entry);
-                
-                z_printf("ELF[%d] entry %x (base=%x e_entry=%x minva=%x)\n", 
+
+                z_printf("ELF[%d] entry %x (bias=%x e_entry=%x)\n",
                          i, (unsigned int)entry[i], (unsigned int)base[i],
-                         (unsigned int)ehdr->e_entry, (unsigned int)minva_for_entry);
+                         (unsigned int)ehdr->e_entry);
                 
                 /* The second round, we've loaded ELF interp. */
                 if (file == elf_interp) {
@@ -217,7 +216,7 @@ void z_entry(unsigned long *sp, void (*fini)(void))
 #define AVSET(t, v, expr) case (t): (v)->a_un.a_val = (expr); break
         while (av->a_type != AT_NULL) {
                 switch (av->a_type) {
-                AVSET(AT_PHDR, av, base[Z_PROG] + ehdrs[Z_PROG].e_phoff);
+                AVSET(AT_PHDR, av, phdr_addr);
                 AVSET(AT_PHNUM, av, ehdrs[Z_PROG].e_phnum);
                 AVSET(AT_PHENT, av, ehdrs[Z_PROG].e_phentsize);
                 AVSET(AT_ENTRY, av, entry[Z_PROG]);
@@ -6,6 +6,11 @@
 #include "z_utils.h"
 #include "z_syscalls.h"
 #include "elf.h"  // For elf_load_and_run declaration
+#include "paging.h"
+#include "vm.h"
+#include "process.h"
+#include "vdso.h"
+#include "pagecache.h"
 
 // Forward declare z_memcpy
 extern void* z_memcpy(void* dest, const void* src, size_t n);
@@ -16,6 +21,9 @@ typedef struct {
     char* buffer;
     uint32_t size;
     uint32_t pos;
+    int owned;      // 1: buffer kmalloc'lı kopya (TinyFS), 0: ramdisk'teki ISO verisi
+    uint32_t dev;   // buffer yoksa dosya page cache'ten okunur: cihaz ve byte offset'i
+    uint32_t dev_offset;
 } kernel_file_t;
 
 static kernel_file_t kernel_files[16];
@@ -78,7 +86,7 @@ static void normalize_path(char* dest, const char* src, int max_len) {
 int z_open(const char *filename, int flags) {
     // Write to a fixed VGA location that won't be overwritten
     // Use row 24 (near bottom) to avoid screen clearing
-    volatile char* vga = (volatile char*)0xB8000;
+    volatile char* vga = (volatile char*)P2V(0xB8000);
     int offset = 24 * 80 * 2;  // Row 24
     vga[offset + 0] = 'Z';
     vga[offset + 1] = 0x0F;  // White on black
@@ -99,13 +107,29 @@ int z_open(const char *filename, int flags) {
     
     char* loaded_buffer = 0;
     uint32_t loaded_size = 0;
-    int load_result = load_file_into_buffer(filename, &loaded_buffer, &loaded_size);
-    
-    if (load_result != 0) {
-        // Try normalized (uppercase + trimmed) path as fallback
-        char normalized[256];
-        normalize_path(normalized, filename, sizeof(normalized));
-        load_result = load_file_into_buffer(normalized, &loaded_buffer, &loaded_size);
+    char normalized[256];
+    normalize_path(normalized, filename, sizeof(normalized));
+
+    // Ramdisk'te duran ISO dosyaları kopyalanmaz, segmentler oradan eşlenir.
+    // Ramdisk'te olmayan ISO dosyası da heap'e okunmaz: header'lar ve
+    // segmentler page cache'ten gelir.
+    const uint8_t* extent = 0;
+    int owned = 0;
+    uint32_t dev = 0, dev_offset = 0;
+    int load_result = fs_file_extent((char*)filename, &extent, &loaded_size);
+    if (load_result != 0) load_result = fs_file_extent(normalized, &extent, &loaded_size);
+    if (load_result == 0) {
+        loaded_buffer = (char*)extent;
+    } else if (fs_file_cache_extent((char*)filename, &dev, &dev_offset, &loaded_size) == 0 ||
+               fs_file_cache_extent(normalized, &dev, &dev_offset, &loaded_size) == 0) {
+        load_result = 0;
+    } else {
+        owned = 1;
+        load_result = load_file_into_buffer(filename, &loaded_buffer, &loaded_size);
+        if (load_result != 0) {
+            // Try normalized (uppercase + trimmed) path as fallback
+            load_result = load_file_into_buffer(normalized, &loaded_buffer, &loaded_size);
+        }
     }
     
     if (load_result != 0) {
@@ -124,7 +148,10 @@ int z_open(const char *filename, int flags) {
     f->buffer = loaded_buffer;
     f->size = loaded_size;
     f->pos = 0;
-    
+    f->owned = owned;
+    f->dev = dev;
+    f->dev_offset = dev_offset;
+
     return next_fd++;
 }
 
@@ -139,11 +166,27 @@ ssize_t z_read(int fd, void *buf, size_t count) {
     if (f->pos + to_read > f->size)
         to_read = f->size - f->pos;
     
-    extern void* z_memcpy(void* dest, const void* src, size_t n);
-    z_memcpy(buf, f->buffer + f->pos, to_read);
-    f->pos += to_read;
-    
-    return to_read;
+    if (f->buffer) {
+        z_memcpy(buf, f->buffer + f->pos, to_read);
+        f->pos += to_read;
+        return to_read;
+    }
+
+    // Page cache'ten sayfa sayfa
+    size_t done = 0;
+    while (done < to_read) {
+        uint32_t pos = f->dev_offset + f->pos;
+        const uint8_t* page = pagecache_get(f->dev, pos >> PAGE_SHIFT);
+        if (!page) break;
+        uint32_t in_page = pos & (PAGE_SIZE - 1);
+        uint32_t n = PAGE_SIZE - in_page;
+        if (n > to_read - done) n = to_read - done;
+        z_memcpy((char*)buf + done, page + in_page, n);
+        f->pos += n;
+        done += n;
+    }
+    if (!done && to_read) return -1;
+    return done;
 }
 
 // Replace z_lseek with kernel buffer
@@ -168,37 +211,112 @@ int z_close(int fd) {
     if (fd < 3 || fd >= 16) return -1;
     kernel_file_t* f = &kernel_files[fd];
     
-    if (f->buffer) {
-        kfree(f->buffer);
-        f->buffer = 0;
-    }
+    if (f->buffer && f->owned) kfree(f->buffer);
+    f->buffer = 0;
+    f->dev = 0;
     return 0;
 }
 
-// Replace z_mmap - just return the address (kernel space, no mapping needed)
+// Replace z_mmap - VMA'lı mmap, sayfalar ilk erişimde doldurulur. Ramdisk'teki
+// ve page cache'teki dosyalar kopyalanmadan eşlenir, heap'e okunmuş dosyalar
+// hemen kopyalanır.
+// PROT_NONE loader'ın yer ayırmasıdır: sadece aralığın boş olduğuna bakılır,
+// segmentler üstüne z_map_segment ile gelir.
 void *z_mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset) {
-    // In kernel space, we can write directly to addresses
-    // Just return the requested address if MAP_FIXED
-    if (flags & MAP_FIXED) {
-        return addr;
+    struct mm* mm = mm_current();
+    uint32_t size = (length + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    uint32_t start;
+
+    if (!size || !mm || (offset & (PAGE_SIZE - 1))) {
+        return (void*)-1;
+    }
+    if (prot == PROT_NONE) {
+        start = (flags & MAP_FIXED) ? (uint32_t)addr : mm_find_free(mm, USER_MMAP_BASE, size);
+        if (!start || (start & (PAGE_SIZE - 1))) return (void*)-1;
+        return mm_find_free(mm, start, size) == start ? (void*)start : (void*)-1;
+    }
+
+    kernel_file_t* f = 0;
+    const uint8_t* data = 0;
+    uint32_t data_size = 0;
+    if (!(flags & MAP_ANONYMOUS)) {
+        if (fd < 3 || fd >= 16 || (!kernel_files[fd].buffer && !kernel_files[fd].dev)) return (void*)-1;
+        f = &kernel_files[fd];
+        if (!f->buffer) {
+            data_size = (uint32_t)offset < f->size ? f->size - (uint32_t)offset : 0;
+            if (data_size > size) data_size = size;
+            start = mm_get_unmapped_area(mm, (uint32_t)addr, size, flags & MAP_FIXED);
+            if (!start || mm_map_cache(mm, start, size, prot & VM_ACCESS, f->dev,
+                                       f->dev_offset + (uint32_t)offset, data_size) < 0) {
+                return (void*)-1;
+            }
+            return (void*)start;
+        }
+        if ((uint32_t)offset < f->size) {
+            data = (const uint8_t*)f->buffer + offset;
+            data_size = f->size - (uint32_t)offset;
+            if (data_size > size) data_size = size;
+        }
     }
-    // For dynamic, allocate from kernel heap
-    if (flags & MAP_ANONYMOUS) {
-        return kmalloc(length);
+
+    int copy = f && f->owned && data;
+    start = mm_mmap(mm, (uint32_t)addr, size, prot & VM_ACCESS, flags & MAP_FIXED, copy ? 0 : data, data_size);
+    if (!start) return (void*)-1;
+    if (copy && mm_load_file(mm, start, data_size, prot & VM_ACCESS, data, data_size) < 0) {
+        mm_unmap(mm, start, size);
+        return (void*)-1;
     }
-    return (void*)-1;
+    return (void*)start;
 }
 
-// Replace z_munmap - no-op in kernel space
+// loader.c'nin PT_LOAD eşlemesi: [addr, addr+size) segmenti, dosyanın offset'inden
+// filesz byte'ı, kalanı sıfır. Dosya ramdisk'te ya da ISO'daysa sayfalar ilk
+// erişimde (ISO'dakiler page cache'ten) doldurulur; TinyFS kopyasıysa ya da
+// segment bir öncekiyle sayfa paylaşıyorsa hemen kopyalanır.
+int z_map_segment(void *addr, size_t size, int prot, int fd, off_t offset, size_t filesz) {
+    struct mm* mm = mm_current();
+    if (!mm || fd < 3 || fd >= 16 || filesz > size) return -1;
+    kernel_file_t* f = &kernel_files[fd];
+    if ((!f->buffer && !f->dev) || (uint32_t)offset > f->size || filesz > f->size - (uint32_t)offset) return -1;
+
+    uint32_t vaddr = (uint32_t)addr;
+    uint32_t head = vaddr & (PAGE_SIZE - 1);
+    uint32_t flags = VM_READ | ((prot & PROT_WRITE) ? VM_WRITE : 0) | ((prot & PROT_EXEC) ? VM_EXEC : 0);
+    const uint8_t* data = (const uint8_t*)f->buffer + offset;
+
+    if (f->buffer && !f->owned && (uint32_t)offset >= head &&
+        mm_map_file(mm, vaddr - head, size + head, flags, data - head, filesz + head) == 0) {
+        return 0;
+    }
+    if (f->dev && (uint32_t)offset >= head &&
+        mm_map_cache(mm, vaddr - head, size + head, flags, f->dev,
+                     f->dev_offset + (uint32_t)offset - head, filesz + head) == 0) {
+        return 0;
+    }
+    if (!f->buffer) return mm_load_cache(mm, vaddr, size, flags, f->dev, f->dev_offset + (uint32_t)offset, filesz);
+    return mm_load_file(mm, vaddr, size, flags, data, filesz);
+}
+
+// loader.c: programın son segmentinin sonu, brk heap'i buradan büyür
+void z_set_brk(unsigned long start) {
+    struct mm* mm = mm_current();
+    if (mm) mm_set_brk(mm, (uint32_t)start);
+}
+
+// Replace z_munmap - sayfaları kaldırıp pmm'e geri ver, area'ları kırp
 int z_munmap(void *addr, size_t length) {
-    // In kernel space, we don't unmap
-    // Could kfree if it was allocated, but for simplicity, just return success
-    return 0;
+    struct mm* mm = mm_current();
+    if (!mm) return -1;
+    return mm_unmap(mm, (uint32_t)addr, (length + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1));
 }
 
-// Replace z_mprotect - no-op in kernel space (no protection)
+// Replace z_mprotect - area'ların ve eşli sayfaların izinlerini güncelle
 int z_mprotect(void *addr, size_t length, int prot) {
-    return 0;
+    struct mm* mm = mm_current();
+    uint32_t start = (uint32_t)addr & ~(PAGE_SIZE - 1);
+    uint32_t end = (uint32_t)addr + length;
+    if (!mm || end < start) return -1;
+    return mm_protect(mm, start, ((end - start) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1), prot & VM_ACCESS);
 }
 
 // Replace z_write - use kernel print
@@ -232,10 +350,11 @@ int program_exit_requested = 0;
 
 // Main entry point wrapper
 int elf_load_and_run(const char* filename) {
-    // Build stack: argc=2, argv[0]="loader", argv[1]=filename, argv[2]=NULL, envp=NULL, auxv=AT_NULL
+    // Build stack: argc=2, argv[0]="loader", argv[1]=filename, argv[2]=NULL, envp=NULL,
+    // auxv=AT_SYSINFO_EHDR, AT_NULL
     // Stack layout (from top to bottom):
-    //   auxv[1] = 0
-    //   auxv[0] = AT_NULL
+    //   auxv[1] = AT_NULL, 0
+    //   auxv[0] = AT_SYSINFO_EHDR, VDSO_TEXT_ADDR
     //   envp = NULL
     //   argv[2] = NULL
     //   argv[1] = pointer to filename string
@@ -243,7 +362,19 @@ int elf_load_and_run(const char* filename) {
     //   argc = 2
     //   (strings at lower addresses)
     
-    uint32_t user_stack_top = 0x800000 + 0x100000;  // USER_STACK_START + USER_STACK_SIZE
+    // Program kendi page directory'sinde çalışır: kernel yarısı ortak,
+    // ELF segmentleri ve stack user penceresinde
+    struct mm* mm = mm_create();
+    if (!mm) return -1;
+    if (mm_map_stack(mm) < 0 ||
+        vdso_map(mm) < 0 ||
+        !process_start_program((char*)filename, mm)) {
+        mm_destroy(mm);
+        return -1;
+    }
+    mm_switch(mm);
+
+    uint32_t user_stack_top = USER_STACK_TOP;
     uint32_t* stack = (uint32_t*)user_stack_top;
     
     // First, allocate space for strings at lower addresses
@@ -269,14 +400,18 @@ int elf_load_and_run(const char* filename) {
     argv1_str[pos] = 0;
     
     // Now build the stack frame from top down
-    // auxv[1] = 0
+    // auxv[1] = AT_NULL
     stack = (uint32_t*)user_stack_top;
     stack -= 1;
     stack[0] = 0;  // auxv[1].a_val
+    stack -= 1;
+    stack[0] = AT_NULL;  // auxv[1].a_type
     
-    // auxv[0] = AT_NULL
+    // auxv[0] = AT_SYSINFO_EHDR: time/gettimeofday/getpid syscall'sız
     stack -= 1;
-    stack[0] = AT_NULL;  // auxv[0].a_type
+    stack[0] = VDSO_TEXT_ADDR;  // auxv[0].a_val
+    stack -= 1;
+    stack[0] = AT_SYSINFO_EHDR;  // auxv[0].a_type
     
     // envp = NULL
     stack -= 1;
@@ -353,8 +488,16 @@ int elf_load_and_run(const char* filename) {
     saved_kernel_ebp_for_exit = saved_kernel_ebp;
     elf_exit_label_addr = exit_label;
     
-    // Mask hardware interrupts
-    __asm__ volatile("outb %%al, %%dx" : : "a"((uint8_t)0xFF), "d"((uint16_t)0x21));
+    // Programın kernel stack'i: ring 3'ten gelen interrupt'lar (int 0x80,
+    // timer) bu frame'in altını kullanır; z_entry'nin frame'lerine program
+    // başladıktan sonra dönülmez. Fork'lanan child'ların kendi stack'i var.
+    extern void tss_set_kernel_stack(uint32_t, uint32_t);
+    current_process->kstack_top = saved_kernel_esp - 16;
+    tss_set_kernel_stack(0x10, current_process->kstack_top);
+    
+    // Timer ve klavye dışındaki hardware interrupt'ları maskele (vDSO saati
+    // işlemeye devam etsin, program bitince shell'i tuşlar uyandırsın)
+    __asm__ volatile("outb %%al, %%dx" : : "a"((uint8_t)0xFC), "d"((uint16_t)0x21));
     __asm__ volatile("outb %%al, %%dx" : : "a"((uint8_t)0xFF), "d"((uint16_t)0xA1));
     
     // Enable interrupts
@@ -374,6 +517,13 @@ int elf_load_and_run(const char* filename) {
     saved_kernel_esp = 0;
     saved_kernel_ebp = 0;
     elf_exit_label_addr = 0;
+
+    // Kernel directory'sine dön; program ve fork'ladığı process'ler
+    // bütün sayfalarıyla birlikte bırakılır
+    process_end_program();
+    
+    // Çıkış yolları cli ile geliyor; shell'de timer işlemeye devam etsin
+    __asm__ volatile("sti");
     
     return 0;
 }
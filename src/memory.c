@@ -1,70 +1,709 @@
 #include "memory.h"
+#include "z_utils.h"
+#include "paging.h"
+#include "timer.h"
 
-#define HEAP_START 0x1000000  // 16MB'da başla
-#define HEAP_SIZE 0x10000000  // 256MB heap (increased from 64MB to handle large allocations)
+// Slab'lar ve büyük block heap bölgeleri buddy allocator'dan (pmm) gelir.
+// Slab'lar SLAB_SIZE'lık parçalardır, her parça tek bir boyut sınıfına hizmet eder.
+#define SLAB_ORDER        2           // 2^2 sayfa = 16KB per slab (SLAB_SIZE hizalı)
+#define SLAB_SIZE         (PAGE_SIZE << SLAB_ORDER)
+#define SLAB_HEADER_SIZE  32          // struct slab, 16 byte hizalı nesneler için yuvarlanmış
+#define SLAB_MAGIC        0x51AB51AB
+
+// Heap bu order'dan küçük olmayan parçalarla büyür (2^10 sayfa = 4MB)
+#define HEAP_GROW_ORDER   10
+
+// Bu boyuttan büyük kcalloc'lar kendi bölgesini pmm'den sıfırlanmış sayfalarla alır
+#define KCALLOC_REGION_MIN 0x10000
+
+// Boyut sınıfları: 16, 32, 64, ... 2048
+#define SLAB_MIN_SHIFT    4
+#define SLAB_CLASSES      8
+#define SLAB_MAX_OBJECT   (1 << (SLAB_MIN_SHIFT + SLAB_CLASSES - 1))
+
+// Slab başlığı - her slab'ın ilk byte'larında durur
+struct slab {
+    uint32_t magic;
+    uint16_t size_class;
+    uint16_t inuse;          // Kullanımdaki nesne sayısı
+    void* free;              // Boş nesne listesi (nesnenin ilk 4 byte'ı = next)
+    struct slab* next;       // Partial listesi
+    struct slab* prev;
+};
+
+// Her boyut sınıfı için cache
+struct slab_cache {
+    uint32_t object_size;
+    uint32_t objects_per_slab;
+    struct slab* partial;    // İçinde en az bir boş nesne olan slab'lar
+};
 
-static struct memory_block* heap_start = (struct memory_block*)HEAP_START;
 static uint8_t heap_initialized = 0;
 
+// Boş büyük block'lar boyuta göre 2'nin kuvveti bin'lerinde durur:
+// bin k, payload'ı [2^k, 2^(k+1)) olan block'ları tutar. free_bin_map'in
+// k. biti bin k boş değilse set, uygun bin tek bit taramasıyla bulunur.
+#define FREE_BINS       32
+#define BIN_SCAN_LIMIT  8       // Aynı bin içinde best-fit için bakılan block sayısı
+static struct memory_block* free_bins[FREE_BINS];
+static uint32_t free_bin_map = 0;
+
+static uint32_t heap_regions = 0;                    // pmm'den alınmış bölge sayısı
+
+// Sayaçlar (meminfo). Byte'lar istenen değil gerçekten ayrılan boyuttur.
+static struct heap_stats stats;
+
+static struct slab_cache slab_caches[SLAB_CLASSES];
+
 void memory_init() {
     if (heap_initialized) return;
-    
-    // İlk block'u ayarla
-    heap_start->size = HEAP_SIZE - sizeof(struct memory_block);
-    heap_start->used = 0;
-    heap_start->next = 0;
-    
+
+    pmm_init();
+
+    // Slab cache'lerini ayarla
+    for (int i = 0; i < SLAB_CLASSES; i++) {
+        slab_caches[i].object_size = 1 << (SLAB_MIN_SHIFT + i);
+        slab_caches[i].objects_per_slab = (SLAB_SIZE - SLAB_HEADER_SIZE) / slab_caches[i].object_size;
+        slab_caches[i].partial = 0;
+    }
+
+    // Büyük block heap'i ilk kmalloc'ta pmm'den büyür
+    for (int i = 0; i < FREE_BINS; i++) free_bins[i] = 0;
+    free_bin_map = 0;
+    heap_regions = 0;
+    z_memset(&stats, 0, sizeof(stats));
+
     heap_initialized = 1;
 }
 
+// --- Slab allocator ---
+
+static int slab_class_for(uint32_t size) {
+    int cls = 0;
+    uint32_t object_size = 1 << SLAB_MIN_SHIFT;
+    while (object_size < size) {
+        object_size <<= 1;
+        cls++;
+    }
+    return cls;
+}
+
+static int slab_owns(void* ptr) {
+    struct page* pg = pmm_page(V2P(ptr));
+    return pg && (pg->flags & PG_SLAB);
+}
+
+static void slab_list_remove(struct slab_cache* cache, struct slab* s) {
+    if (s->prev) s->prev->next = s->next;
+    else cache->partial = s->next;
+    if (s->next) s->next->prev = s->prev;
+    s->next = 0;
+    s->prev = 0;
+}
+
+static void slab_list_push(struct slab_cache* cache, struct slab* s) {
+    s->prev = 0;
+    s->next = cache->partial;
+    if (cache->partial) cache->partial->prev = s;
+    cache->partial = s;
+}
+
+// Yeni bir slab al ve nesnelerini boş listeye diz
+static struct slab* slab_create(int cls) {
+    uint32_t addr = pmm_alloc(SLAB_ORDER);
+    if (!addr) return 0; // Fiziksel bellek yok
+    for (int i = 0; i < (1 << SLAB_ORDER); i++) {
+        pmm_page(addr + i * PAGE_SIZE)->flags |= PG_SLAB;
+    }
+    struct slab* s = (struct slab*)P2V(addr);
+
+    struct slab_cache* cache = &slab_caches[cls];
+    s->magic = SLAB_MAGIC;
+    s->size_class = cls;
+    s->inuse = 0;
+    s->next = 0;
+    s->prev = 0;
+
+    // Nesneleri sondan başa dizerek free listesini oluştur
+    uint8_t* objects = (uint8_t*)s + SLAB_HEADER_SIZE;
+    void* head = 0;
+    for (int i = cache->objects_per_slab - 1; i >= 0; i--) {
+        void** obj = (void**)(objects + i * cache->object_size);
+        *obj = head;
+        head = obj;
+    }
+    s->free = head;
+    return s;
+}
+
+static void* slab_alloc(uint32_t size) {
+    int cls = slab_class_for(size);
+    struct slab_cache* cache = &slab_caches[cls];
+
+    struct slab* s = cache->partial;
+    if (!s) {
+        s = slab_create(cls);
+        if (!s) return 0;
+        slab_list_push(cache, s);
+    }
+
+    void** obj = (void**)s->free;
+    s->free = *obj;
+    s->inuse++;
+
+    // Slab doldu, partial listesinden çıkar
+    if (!s->free) {
+        slab_list_remove(cache, s);
+    }
+    return obj;
+}
+
+// Serbest bırakılan byte'ları döner, pointer geçersizse 0
+static uint32_t slab_free(void* ptr) {
+    struct slab* s = (struct slab*)((uint32_t)ptr & ~(SLAB_SIZE - 1));
+    if (s->magic != SLAB_MAGIC) return 0; // Bozuk pointer
+
+    struct slab_cache* cache = &slab_caches[s->size_class];
+    int was_full = (s->free == 0);
+
+    *(void**)ptr = s->free;
+    s->free = ptr;
+    s->inuse--;
+
+    if (was_full) {
+        slab_list_push(cache, s);
+    }
+
+    // Tamamen boşaldı - cache'de başka partial slab varsa sayfayı geri ver
+    if (s->inuse == 0 && (s->prev || s->next)) {
+        slab_list_remove(cache, s);
+        s->magic = 0;
+        pmm_free(V2P(s), SLAB_ORDER);
+    }
+    return cache->object_size;
+}
+
+// --- Büyük bloklar: boundary tag'li heap ---
+//
+// Her block'un header'ı fiziksel olarak önceki block'un boyutunu (prev_size)
+// taşır, böylece her iki komşuya da O(1)'de ulaşılır. Boş block'lar boyut
+// bin'lerindeki çift yönlü listelerde durur; kfree heap'i hiç yürümez.
+
+#define BLOCK_HEADER_SIZE sizeof(struct memory_block)
+#define BLOCK_MIN_PAYLOAD 16
+
+static inline uint32_t block_size(struct memory_block* b) {
+    return b->size & BLOCK_SIZE_MASK;
+}
+
+static inline struct memory_block* block_next_phys(struct memory_block* b) {
+    return (struct memory_block*)((uint8_t*)b + BLOCK_HEADER_SIZE + block_size(b));
+}
+
+static inline struct memory_block* block_prev_phys(struct memory_block* b) {
+    return (struct memory_block*)((uint8_t*)b - b->prev_size - BLOCK_HEADER_SIZE);
+}
+
+static inline int bin_index(uint32_t size) {
+    return 31 - __builtin_clz(size);
+}
+
+// Block'un boyutu listedeyken değişmemeli: önce remove, sonra insert
+static void free_list_insert(struct memory_block* b) {
+    int bin = bin_index(block_size(b));
+    b->prev = 0;
+    b->next = free_bins[bin];
+    if (free_bins[bin]) free_bins[bin]->prev = b;
+    free_bins[bin] = b;
+    free_bin_map |= 1u << bin;
+    stats.free_blocks++;
+}
+
+static void free_list_remove(struct memory_block* b) {
+    int bin = bin_index(block_size(b));
+    if (b->prev) b->prev->next = b->next;
+    else free_bins[bin] = b->next;
+    if (b->next) b->next->prev = b->prev;
+    if (!free_bins[bin]) free_bin_map &= ~(1u << bin);
+    b->next = 0;
+    b->prev = 0;
+    stats.free_blocks--;
+}
+
+// size'a yeten bir boş block: önce kendi bin'inde sınırlı best-fit,
+// sonra boş olmayan ilk üst bin (oradaki her block sığar)
+static struct memory_block* free_list_find(uint32_t size) {
+    int bin = bin_index(size);
+    struct memory_block* best = 0;
+    int scanned = 0;
+    for (struct memory_block* b = free_bins[bin]; b && scanned < BIN_SCAN_LIMIT; b = b->next, scanned++) {
+        if (block_size(b) >= size && (!best || block_size(b) < block_size(best))) best = b;
+    }
+    if (best) return best;
+
+    uint32_t above = free_bin_map & ~((2u << bin) - 1);
+    if (above) return free_bins[__builtin_ctz(above)];
+
+    // Üstte yer yok: kendi bin'inin kalanına bak
+    for (struct memory_block* b = free_bins[bin]; b; b = b->next) {
+        if (block_size(b) >= size) return b;
+    }
+    return 0;
+}
+
+// [start, start+size) aralığını tek boş block + bitiş sentinel'i olarak hazırla
+static void heap_add_region(uint32_t start, uint32_t size) {
+    heap_regions++;
+    struct memory_block* first = (struct memory_block*)start;
+    struct memory_block* sentinel = (struct memory_block*)(start + size - BLOCK_HEADER_SIZE);
+    uint32_t payload = size - 2 * BLOCK_HEADER_SIZE;
+
+    first->size = payload | BLOCK_FIRST;
+    first->prev_size = 0;
+    sentinel->size = BLOCK_USED;
+    sentinel->prev_size = payload;
+    sentinel->next = 0;
+    sentinel->prev = 0;
+    free_list_insert(first);
+}
+
+// pmm'den en az size byte'lık payload taşıyabilecek yeni bir bölge al
+static int heap_grow(uint32_t size) {
+    uint32_t bytes = size + 2 * BLOCK_HEADER_SIZE;
+    if (bytes < size) return 0;
+    uint32_t needed = (bytes + PAGE_SIZE - 1) / PAGE_SIZE;
+    uint32_t npages = needed;
+    if (npages < (1u << HEAP_GROW_ORDER)) npages = 1u << HEAP_GROW_ORDER;
+
+    uint32_t addr = pmm_alloc_pages(npages);
+    // 4MB'lık parça yoksa isteğe yetecek kadarını dene
+    if (!addr && npages != needed) {
+        npages = needed;
+        addr = pmm_alloc_pages(npages);
+    }
+    if (!addr) return 0;
+
+    heap_add_region((uint32_t)P2V(addr), npages * PAGE_SIZE);
+    return 1;
+}
+
+// Free listesinden çıkarılmış block'u size'a göre böl ve kullanımda işaretle
+static void* block_take(struct memory_block* current, uint32_t size) {
+    uint32_t total = block_size(current);
+
+    // Eğer block çok büyükse böl, kalan kısmı free listesine koy
+    if (total >= size + BLOCK_HEADER_SIZE + BLOCK_MIN_PAYLOAD) {
+        struct memory_block* rest = (struct memory_block*)((uint8_t*)current + BLOCK_HEADER_SIZE + size);
+        uint32_t rest_size = total - size - BLOCK_HEADER_SIZE;
+        rest->size = rest_size;
+        rest->prev_size = size;
+        block_next_phys(rest)->prev_size = rest_size;
+        free_list_insert(rest);
+        current->size = (current->size & BLOCK_FIRST) | size;
+    }
+
+    current->size |= BLOCK_USED;
+    return (void*)((uint8_t*)current + BLOCK_HEADER_SIZE);
+}
+
+static void* large_alloc(uint32_t size) {
+    if (size > 0xFFFFFFF0u - BLOCK_MIN_PAYLOAD) return 0;
+    size = (size + 15) & ~15;
+    if (size < BLOCK_MIN_PAYLOAD) size = BLOCK_MIN_PAYLOAD;
+
+    struct memory_block* current = free_list_find(size);
+    if (!current) {
+        if (!heap_grow(size)) return 0; // Memory yok
+        current = free_list_find(size);
+        if (!current) return 0;
+    }
+
+    free_list_remove(current);
+    return block_take(current, size);
+}
+
+// Payload'ı align'a hizalı block. Hizalamak için atlanan baş kısım
+// ayrı bir boş block olarak listede kalır, sonuç normal kfree ile döner.
+static void* large_alloc_aligned(uint32_t size, uint32_t align) {
+    if (size > 0xFFFFFFF0u - align - 2 * BLOCK_HEADER_SIZE - BLOCK_MIN_PAYLOAD) return 0;
+    size = (size + 15) & ~15;
+    if (size < BLOCK_MIN_PAYLOAD) size = BLOCK_MIN_PAYLOAD;
+
+    struct memory_block* current = 0;
+    uint32_t payload = 0, aligned = 0;
+    for (int attempt = 0; attempt < 2 && !current; attempt++) {
+        // size'dan küçük block'ların bin'leri atlanır
+        for (int bin = bin_index(size); bin < FREE_BINS && !current; bin++) {
+            if (!(free_bin_map & (1u << bin))) continue;
+            for (current = free_bins[bin]; current; current = current->next) {
+                payload = (uint32_t)current + BLOCK_HEADER_SIZE;
+                aligned = payload;
+                if (aligned & (align - 1)) {
+                    // Baş boşluk en az bir header + minimum payload olmalı
+                    aligned = (payload + BLOCK_HEADER_SIZE + BLOCK_MIN_PAYLOAD + align - 1) & ~(align - 1);
+                }
+                if (aligned + size <= payload + block_size(current)) break;
+            }
+        }
+        if (!current && (attempt || !heap_grow(size + align + BLOCK_HEADER_SIZE + BLOCK_MIN_PAYLOAD))) {
+            return 0;
+        }
+    }
+
+    free_list_remove(current);
+    if (aligned != payload) {
+        struct memory_block* b = (struct memory_block*)(aligned - BLOCK_HEADER_SIZE);
+        uint32_t lead = (uint32_t)b - payload;
+        b->size = block_size(current) - lead - BLOCK_HEADER_SIZE;
+        b->prev_size = lead;
+        current->size = (current->size & BLOCK_FIRST) | lead;
+        block_next_phys(b)->prev_size = block_size(b);
+        free_list_insert(current);
+        current = b;
+    }
+    return block_take(current, size);
+}
+
+// Bölge tamamen boşaldıysa sayfaları pmm'e geri ver. Tek kalan normal
+// boyutlu bölge tutulur ki kmalloc/kfree döngüsü pmm'e gidip gelmesin.
+static void heap_release_region(struct memory_block* b) {
+    if (!(b->size & BLOCK_FIRST)) return;
+    struct memory_block* sentinel = block_next_phys(b);
+    if (block_size(sentinel) != 0) return; // Bölgede hâlâ kullanılan block var
+
+    uint32_t region_size = block_size(b) + 2 * BLOCK_HEADER_SIZE;
+    if (heap_regions <= 1 && region_size <= (PAGE_SIZE << HEAP_GROW_ORDER)) return;
+
+    free_list_remove(b);
+    heap_regions--;
+    pmm_free_pages(V2P(b), region_size / PAGE_SIZE);
+}
+
+// Serbest bırakılan byte'ları döner, double free'de 0
+static uint32_t large_free(void* ptr) {
+    struct memory_block* block = (struct memory_block*)((uint8_t*)ptr - BLOCK_HEADER_SIZE);
+    if (!(block->size & BLOCK_USED)) return 0; // Double free
+    uint32_t size = block_size(block);
+    block->size &= ~BLOCK_USED;
+
+    // Coalesce with next block if it's free (sentinel her zaman USED)
+    struct memory_block* next = block_next_phys(block);
+    if (!(next->size & BLOCK_USED)) {
+        free_list_remove(next);
+        block->size += BLOCK_HEADER_SIZE + block_size(next);
+    }
+
+    // Coalesce with previous block if it's free
+    if (!(block->size & BLOCK_FIRST)) {
+        struct memory_block* prev = block_prev_phys(block);
+        if (!(prev->size & BLOCK_USED)) {
+            // Boyut değişince bin'i de değişebilir
+            free_list_remove(prev);
+            prev->size += BLOCK_HEADER_SIZE + block_size(block);
+            block_next_phys(prev)->prev_size = block_size(prev);
+            free_list_insert(prev);
+            heap_release_region(prev);
+            return size;
+        }
+    }
+
+    block_next_phys(block)->prev_size = block_size(block);
+    free_list_insert(block);
+    heap_release_region(block);
+    return size;
+}
+
+// --- Sayaçlar ---
+
+static int stats_bucket(uint32_t size) {
+    int bucket = 0;
+    while (bucket < HEAP_STAT_BUCKETS - 1 && (16u << bucket) < size) bucket++;
+    return bucket;
+}
+
+static void stats_bytes(uint32_t bytes) {
+    stats.bytes_in_use += bytes;
+    if (stats.bytes_in_use > stats.peak_bytes) stats.peak_bytes = stats.bytes_in_use;
+}
+
+static void stats_add(uint32_t requested, uint32_t bytes) {
+    stats.alloc_count[stats_bucket(requested)]++;
+    stats_bytes(bytes);
+}
+
+// kmalloc'tan dönen pointer'ın gerçek kullanılabilir boyutu
+static uint32_t usable_size(void* ptr) {
+    if (slab_owns(ptr)) {
+        struct slab* s = (struct slab*)((uint32_t)ptr & ~(SLAB_SIZE - 1));
+        return slab_caches[s->size_class].object_size;
+    }
+    return block_size((struct memory_block*)((uint8_t*)ptr - BLOCK_HEADER_SIZE));
+}
+
+static void* stats_record(uint32_t size, void* ptr) {
+    if (ptr) stats_add(size, usable_size(ptr));
+    else stats.failed_allocs++;
+    return ptr;
+}
+
 void* kmalloc(uint32_t size) {
     if (!heap_initialized) memory_init();
-    
-    struct memory_block* current = heap_start;
-    
-    while (current) {
-        if (!current->used && current->size >= size) {
-            // Bu block'u kullan
-            current->used = 1;
-            
-            // Eğer block çok büyükse böl
-            if (current->size > size + sizeof(struct memory_block) + 4) {
-                struct memory_block* new_block = (struct memory_block*)((uint8_t*)current + sizeof(struct memory_block) + size);
-                new_block->size = current->size - size - sizeof(struct memory_block);
-                new_block->used = 0;
-                new_block->next = current->next;
-                
-                current->size = size;
-                current->next = new_block;
+
+    // Küçük istekler O(1) slab yolundan gider
+    if (size <= SLAB_MAX_OBJECT) {
+        void* ptr = slab_alloc(size);
+        if (ptr) return stats_record(size, ptr);
+        // Slab için sayfa kalmadıysa büyük listeye düş
+    }
+    return stats_record(size, large_alloc(size));
+}
+
+void* kmalloc_aligned(uint32_t size, uint32_t align) {
+    if (!heap_initialized) memory_init();
+    if (align & (align - 1)) return 0; // 2'nin kuvveti değil
+
+    // Slab nesneleri ve büyük block payload'ları zaten 16 byte hizalı
+    if (align <= 16) return kmalloc(size);
+    return stats_record(size, large_alloc_aligned(size, align));
+}
+
+// Büyük kcalloc: pmm'den sıfırlanmış sayfalarla tek block'luk yeni bölge.
+// Boşta sıfırlanmış (PG_ZERO) sayfalar tekrar memset edilmez.
+static void* large_alloc_zeroed(uint32_t size) {
+    size = (size + 15) & ~15;
+    uint32_t npages = (size + 2 * BLOCK_HEADER_SIZE + PAGE_SIZE - 1) / PAGE_SIZE;
+    uint32_t phys = pmm_alloc_pages_zeroed(npages);
+    if (!phys) return 0;
+
+    uint32_t addr = (uint32_t)P2V(phys);
+    heap_add_region(addr, npages * PAGE_SIZE);
+    struct memory_block* first = (struct memory_block*)addr;
+    free_list_remove(first);
+    return block_take(first, size);
+}
+
+void* kcalloc(uint32_t count, uint32_t size) {
+    if (!heap_initialized) memory_init();
+    if (size && count > 0xFFFFFFFFu / size) {
+        stats.failed_allocs++;
+        return 0;
+    }
+    uint32_t total = count * size;
+
+    if (total >= KCALLOC_REGION_MIN && total <= 0xFFFFFFFFu - PAGE_SIZE) {
+        void* ptr = large_alloc_zeroed(total);
+        if (ptr) return stats_record(total, ptr);
+    }
+
+    void* ptr = kmalloc(total);
+    if (ptr) z_memset(ptr, 0, total);
+    return ptr;
+}
+
+// Büyük block yerinde büyür (sağdaki boş komşuyu yutarak) veya küçülür;
+// olmazsa yeni yere kopyalanır
+void* krealloc(void* ptr, uint32_t size) {
+    if (!ptr) return kmalloc(size);
+    if (size == 0) {
+        kfree(ptr);
+        return 0;
+    }
+
+    uint32_t old_size = usable_size(ptr);
+    if (!slab_owns(ptr) && size <= 0xFFFFFFF0u - BLOCK_MIN_PAYLOAD) {
+        struct memory_block* b = (struct memory_block*)((uint8_t*)ptr - BLOCK_HEADER_SIZE);
+        struct memory_block* next = block_next_phys(b);
+        uint32_t want = (size + 15) & ~15;
+        if (want < BLOCK_MIN_PAYLOAD) want = BLOCK_MIN_PAYLOAD;
+
+        uint32_t avail = old_size;
+        if (!(next->size & BLOCK_USED)) avail += BLOCK_HEADER_SIZE + block_size(next);
+
+        if (want <= avail) {
+            if (!(next->size & BLOCK_USED)) {
+                free_list_remove(next);
+                b->size += BLOCK_HEADER_SIZE + block_size(next);
+                block_next_phys(b)->prev_size = block_size(b);
             }
-            
-            return (void*)((uint8_t*)current + sizeof(struct memory_block));
+            b->size &= ~BLOCK_USED;
+            block_take(b, want);
+            stats.bytes_in_use -= old_size;
+            stats_bytes(block_size(b));
+            return ptr;
         }
-        current = current->next;
+    } else if (slab_owns(ptr) && size <= old_size) {
+        return ptr; // Aynı slab nesnesine hâlâ sığıyor
     }
-    
-    return 0; // Memory yok
+
+    void* fresh = kmalloc(size);
+    if (!fresh) return 0;
+    z_memcpy(fresh, ptr, old_size < size ? old_size : size);
+    kfree(ptr);
+    return fresh;
 }
 
 void kfree(void* ptr) {
     if (!ptr) return;
-    
-    struct memory_block* block = (struct memory_block*)((uint8_t*)ptr - sizeof(struct memory_block));
-    block->used = 0;
-    
-    // Coalesce with next block if it's free
-    if (block->next && !block->next->used) {
-        block->size += sizeof(struct memory_block) + block->next->size;
-        block->next = block->next->next;
-    }
-    
-    // Coalesce with previous block if it's free
-    struct memory_block* prev = heap_start;
-    while (prev && prev->next != block) {
-        prev = prev->next;
+
+    // Slab sayfaları pmm'de PG_SLAB ile işaretli. Sayaç ancak pointer
+    // geçerliyse düşer: bozuk pointer ya da double free istatistiği kaydırmaz.
+    if (slab_owns(ptr)) stats.bytes_in_use -= slab_free(ptr);
+    else stats.bytes_in_use -= large_free(ptr);
+}
+
+// Sayfa granüllü bellek: doğrudan buddy allocator'dan, heap header'ı yok
+void* kpage_alloc(uint32_t npages) {
+    if (!heap_initialized) memory_init();
+    uint32_t phys = pmm_alloc_pages(npages);
+    void* ptr = phys ? P2V(phys) : 0;
+    if (ptr) stats_add(npages * PAGE_SIZE, npages * PAGE_SIZE);
+    else stats.failed_allocs++;
+    return ptr;
+}
+
+// kpage_alloc gibi ama içerik sıfır; boşta sıfırlanmış sayfalar atlanır
+void* kpage_zalloc(uint32_t npages) {
+    if (!heap_initialized) memory_init();
+    uint32_t phys = pmm_alloc_pages_zeroed(npages);
+    void* ptr = phys ? P2V(phys) : 0;
+    if (ptr) stats_add(npages * PAGE_SIZE, npages * PAGE_SIZE);
+    else stats.failed_allocs++;
+    return ptr;
+}
+
+void kpage_free(void* ptr, uint32_t npages) {
+    // Direct map'te sayfa başı olmalı; pmm reddederse sayaç değişmez
+    if (!ptr || ((uint32_t)ptr & (PAGE_SIZE - 1)) || (uint32_t)ptr < PHYS_MAP_BASE) return;
+    stats.bytes_in_use -= pmm_free_pages(V2P(ptr), npages) * PAGE_SIZE;
+}
+
+void memory_get_stats(struct heap_stats* out) {
+    if (!heap_initialized) memory_init();
+    *out = stats;
+    out->heap_regions = heap_regions;
+
+    // En büyük boş extent en yüksek dolu bin'de
+    out->largest_free = 0;
+    if (free_bin_map) {
+        int bin = 31 - __builtin_clz(free_bin_map);
+        for (struct memory_block* b = free_bins[bin]; b; b = b->next) {
+            if (block_size(b) > out->largest_free) out->largest_free = block_size(b);
+        }
     }
-    if (prev && !prev->used && prev != block) {
-        prev->size += sizeof(struct memory_block) + block->size;
-        prev->next = block->next;
+}
+
+// --- Arena ---
+//
+// Chunk'lar kpage_alloc'tan gelir ve arena içinde zincirlenir. arena_begin
+// sadece başa sarar (chunk'lar sonraki kapsamda yeniden kullanılır),
+// arena_reset ilk normal boyutlu chunk dışında hepsini geri verir.
+
+#define ARENA_CHUNK_PAGES 4
+
+struct arena_chunk {
+    struct arena_chunk* next;
+    uint32_t npages;
+    uint32_t used;           // Chunk başından itibaren, header dahil
+    uint32_t pad;
+};
+
+#define ARENA_HEADER_SIZE sizeof(struct arena_chunk)
+
+void arena_begin(struct arena* a) {
+    a->current = a->first;
+    if (a->first) a->first->used = ARENA_HEADER_SIZE;
+}
+
+static int arena_fits(struct arena_chunk* c, uint32_t size) {
+    return c->used + size <= c->npages * PAGE_SIZE;
+}
+
+void* arena_alloc(struct arena* a, uint32_t size) {
+    if (size > 0xFFFFFFF0u - ARENA_HEADER_SIZE - PAGE_SIZE) return 0;
+    size = (size + 15) & ~15;
+
+    struct arena_chunk* c = a->current;
+    if (!c || !arena_fits(c, size)) {
+        // Önceki kapsamlardan kalan chunk'ı dene, yoksa yenisini al
+        struct arena_chunk* next = c ? c->next : a->first;
+        if (next) next->used = ARENA_HEADER_SIZE;
+        if (next && arena_fits(next, size)) {
+            c = next;
+        } else {
+            uint32_t npages = (size + ARENA_HEADER_SIZE + PAGE_SIZE - 1) / PAGE_SIZE;
+            if (npages < ARENA_CHUNK_PAGES) npages = ARENA_CHUNK_PAGES;
+            struct arena_chunk* fresh = (struct arena_chunk*)kpage_alloc(npages);
+            if (!fresh) return 0;
+            fresh->npages = npages;
+            fresh->used = ARENA_HEADER_SIZE;
+            fresh->next = next;
+            if (c) c->next = fresh;
+            else a->first = fresh;
+            c = fresh;
+        }
+        a->current = c;
+    }
+
+    void* ptr = (uint8_t*)c + c->used;
+    c->used += size;
+    return ptr;
+}
+
+void arena_reset(struct arena* a) {
+    struct arena_chunk* keep = a->first;
+    struct arena_chunk* c = keep ? keep->next : 0;
+
+    // Büyük istek için açılmış ilk chunk tutulmaz
+    if (keep && keep->npages > ARENA_CHUNK_PAGES) {
+        c = keep;
+        keep = 0;
+    }
+    while (c) {
+        struct arena_chunk* next = c->next;
+        kpage_free(c, c->npages);
+        c = next;
+    }
+
+    a->first = keep;
+    a->current = keep;
+    if (keep) {
+        keep->next = 0;
+        keep->used = ARENA_HEADER_SIZE;
     }
-} 
\ No newline at end of file
+}
+
+// --- Microbenchmark: N rastgele block'u rastgele sırayla free et ---
+
+void memory_benchmark() {
+    uint32_t seed = 12345;
+    z_printf("kfree benchmark (large blocks, random free order)\n");
+    z_printf("  N       cycles/free\n");
+
+    for (uint32_t n = 256; n <= 8192; n <<= 1) {
+        void** ptrs = (void**)kmalloc(n * sizeof(void*));
+        if (!ptrs) return;
+
+        uint32_t allocated = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            seed = seed * 1103515245 + 12345;
+            ptrs[i] = kmalloc(SLAB_MAX_OBJECT + 1 + ((seed >> 16) & 0xFFF));
+            if (ptrs[i]) allocated++;
+        }
+
+        // Fisher-Yates karıştırma: komşular farklı sıralarda free edilsin
+        for (uint32_t i = n - 1; i > 0; i--) {
+            seed = seed * 1103515245 + 12345;
+            uint32_t j = (seed >> 8) % (i + 1);
+            void* t = ptrs[i]; ptrs[i] = ptrs[j]; ptrs[j] = t;
+        }
+
+        uint64_t start = rdtsc();
+        for (uint32_t i = 0; i < n; i++) {
+            kfree(ptrs[i]);
+        }
+        uint32_t cycles = (uint32_t)(rdtsc() - start);
+        kfree(ptrs);
+
+        z_printf("  %u    %u\n", allocated, allocated ? cycles / allocated : 0);
+    }
+}
@@ -3,18 +3,59 @@
 
 // Memory management için temel yapılar
 typedef unsigned int uint32_t;
+typedef unsigned short uint16_t;
 typedef unsigned char uint8_t;
 
-// Memory block yapısı
+#include "pmm.h"
+
+// Memory block yapısı (16 byte, payload 16 byte hizalı kalır)
+// size: payload boyutu, alt 4 bit bayrak olarak kullanılır
 struct memory_block {
     uint32_t size;
-    uint8_t used;
-    struct memory_block* next;
+    uint32_t prev_size;          // Boundary tag: fiziksel olarak önceki block'un payload boyutu
+    struct memory_block* next;   // Free list bağlantıları (sadece boş block'larda geçerli)
+    struct memory_block* prev;
+};
+
+#define BLOCK_USED      0x1
+#define BLOCK_FIRST     0x2      // Bölgenin ilk block'u, öncesinde block yok
+#define BLOCK_SIZE_MASK (~0xFu)
+
+// kmalloc boyut histogramı: 16, 32, ... 1MB, son bucket daha büyükler
+#define HEAP_STAT_BUCKETS 18
+
+struct heap_stats {
+    uint32_t alloc_count[HEAP_STAT_BUCKETS];  // Toplam ayırma sayısı (kümülatif)
+    uint32_t bytes_in_use;                    // Slab, heap ve kpage dahil
+    uint32_t peak_bytes;
+    uint32_t failed_allocs;
+    uint32_t free_blocks;                     // Büyük block free listesindeki block sayısı
+    uint32_t largest_free;                    // En büyük boş block'un payload'ı
+    uint32_t heap_regions;
+};
+
+// Arena: kısa ömürlü ayırmalar için bump allocator. Sıfırlanmış (static)
+// bir struct arena geçerli boş arenadır; bellek ilk arena_alloc'ta alınır.
+struct arena_chunk;
+struct arena {
+    struct arena_chunk* first;     // arena_reset'ten sonra tutulan chunk
+    struct arena_chunk* current;   // Şu an bump edilen chunk
 };
 
 // Memory manager fonksiyonları
 void memory_init();
 void* kmalloc(uint32_t size);
+void* kmalloc_aligned(uint32_t size, uint32_t align);   // align: 2'nin kuvveti, kfree ile serbest bırakılır
+void* kcalloc(uint32_t count, uint32_t size);          // Sıfırlanmış; büyükse taze sayfalar memset edilmez
+void* krealloc(void* ptr, uint32_t size);               // Mümkünse yerinde büyür/küçülür
 void kfree(void* ptr);
+void* kpage_alloc(uint32_t npages);                     // PAGE_SIZE hizalı, bitişik sayfalar
+void* kpage_zalloc(uint32_t npages);                    // kpage_alloc, içerik sıfır
+void kpage_free(void* ptr, uint32_t npages);
+void arena_begin(struct arena* a);                      // Yeni kapsam: önceki ayırmalar geçersiz
+void* arena_alloc(struct arena* a, uint32_t size);      // 16 byte hizalı, tek tek free edilmez
+void arena_reset(struct arena* a);                      // Hepsini bırak, fazla chunk'ları geri ver
+void memory_get_stats(struct heap_stats* stats);
+void memory_benchmark();
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "pagecache.h"
+#include "memory.h"
+
+// Salt okunur cihazların (ISO) (cihaz, block) anahtarlı 4KB sayfa cache'i.
+// Dosya okumaları buradan kopyalar, mmap/ELF eşlemeleri sayfaları doğrudan
+// (PTE_BORROWED) eşler; aynı block ikinci kez cihazdan ya da ramdisk'ten
+// okunmaz. Sayfalar eşlenmiş olabileceği için hiç atılmaz: cihazlar salt
+// okunur ve boyutu sabit, cache en fazla cihaz kadar büyür.
+
+struct pagecache_entry {
+    uint32_t dev;
+    uint32_t block;
+    const uint8_t* data;
+    struct pagecache_entry* next;
+};
+
+static pagecache_fill_t fills[PAGECACHE_MAX_DEVS];
+static struct pagecache_entry* buckets[PAGECACHE_BUCKETS];
+static struct pagecache_stats stats;
+
+static uint32_t bucket_of(uint32_t dev, uint32_t block) {
+    return (block * 2654435761u + dev) >> 24;
+}
+
+void pagecache_register(uint32_t dev, pagecache_fill_t fill) {
+    if (dev && dev < PAGECACHE_MAX_DEVS) fills[dev] = fill;
+}
+
+const uint8_t* pagecache_get(uint32_t dev, uint32_t block) {
+    if (!dev || dev >= PAGECACHE_MAX_DEVS || !fills[dev]) return 0;
+
+    struct pagecache_entry** head = &buckets[bucket_of(dev, block)];
+    for (struct pagecache_entry* e = *head; e; e = e->next) {
+        if (e->dev == dev && e->block == block) {
+            stats.hits++;
+            return e->data;
+        }
+    }
+
+    struct pagecache_entry* e = (struct pagecache_entry*)kmalloc(sizeof(struct pagecache_entry));
+    if (!e) return 0;
+    const uint8_t* data = fills[dev](block, 0);
+    if (data) {
+        stats.resident++;
+    } else {
+        uint8_t* page = (uint8_t*)kpage_alloc(1);
+        data = page ? fills[dev](block, page) : 0;
+        if (!data) {
+            if (page) kpage_free(page, 1);
+            kfree(e);
+            return 0;
+        }
+        stats.pages++;
+        stats.misses++;
+    }
+
+    e->dev = dev;
+    e->block = block;
+    e->data = data;
+    e->next = *head;
+    *head = e;
+    return data;
+}
+
+void pagecache_get_stats(struct pagecache_stats* out) {
+    *out = stats;
+}
@@ -0,0 +1,33 @@
+#ifndef PAGECACHE_H
+#define PAGECACHE_H
+
+// Kendi typedef'lerimiz
+typedef unsigned char uint8_t;
+typedef unsigned short uint16_t;
+typedef unsigned int uint32_t;
+
+// Cache'lenen cihazlar (0: yok, vm_area'da "dosya cache'te değil" demek)
+#define PAGECACHE_DEV_NONE  0
+#define PAGECACHE_DEV_ISO   1
+#define PAGECACHE_MAX_DEVS  4
+
+#define PAGECACHE_BUCKETS   256
+
+// Cihazın block numaralı 4KB sayfasını getir. page 0 ise sadece zaten
+// bellekte duran (ör. ramdisk) sayfa sorulur; değilse sayfa page'e okunup
+// page döner. Yoksa/okunamazsa 0.
+typedef const uint8_t* (*pagecache_fill_t)(uint32_t block, uint8_t* page);
+
+struct pagecache_stats {
+    uint32_t pages;         // Cihazdan okunup cache'te tutulan sayfalar
+    uint32_t resident;      // Zaten bellekte olduğu için kopyalanmadan kaydedilenler
+    uint32_t hits;
+    uint32_t misses;        // Cihazdan okuma gerektiren erişimler
+};
+
+// Page cache fonksiyonları
+void pagecache_register(uint32_t dev, pagecache_fill_t fill);
+const uint8_t* pagecache_get(uint32_t dev, uint32_t block);
+void pagecache_get_stats(struct pagecache_stats* stats);
+
+#endif
@@ -0,0 +1,559 @@
+#include "paging.h"
+#include "pmm.h"
+#include "interrupts.h"
+#include "z_utils.h"
+#include "vm.h"
+#include "vga.h"
+
+// 32-bit paging. RAM (PMM_PHYS_LIMIT'e kadar) PHYS_MAP_BASE'e, framebuffer
+// FB_VIRT_BASE'e 4MB PSE sayfalarıyla, global bitiyle eşlenir; böylece bütün
+// kernel birkaç düzine TLB girişine sığar ve CR3 değişimlerinde düşmez. Kernel
+// image da higher half'te, RAM eşlemesinin içinde (1MB'a yüklenip
+// PHYS_MAP_BASE + 1MB'a link ediliyor). Her process directory'si bu kernel
+// girişlerini paylaşır; alttaki 3GB (USER_BASE-USER_TOP) tamamen process'e
+// özeldir, CR3 değişimi sadece onun TLB girişlerini düşürür. paging_map/unmap/protect
+// 4KB granülerlikte çalışır, büyük sayfaya denk gelirse onu page table'a böler.
+
+// boot.asm'den
+extern uint32_t framebuffer;
+extern uint32_t fb_pitch;
+extern uint32_t fb_height;
+
+#define CPUID_PSE   (1 << 3)
+#define CPUID_MTRR  (1 << 12)
+#define CPUID_PGE   (1 << 13)
+#define CPUID_PAT   (1 << 16)
+
+#define CR0_WP      0x00010000
+#define CR0_NW      0x20000000
+#define CR0_CD      0x40000000
+#define CR0_PG      0x80000000
+#define CR4_PSE     0x00000010
+#define CR4_PGE     0x00000080
+
+// Cache tipleri için MSR'lar
+#define MSR_MTRRCAP         0xFE
+#define MSR_MTRR_PHYSBASE0  0x200
+#define MSR_MTRR_PHYSMASK0  0x201
+#define MSR_MTRR_DEF_TYPE   0x2FF
+#define MSR_PAT             0x277
+#define MTRRCAP_WC          (1 << 10)
+#define MTRR_ENABLE         (1 << 11)
+#define MTRR_VALID          (1 << 11)
+#define MEM_TYPE_UC         0x00
+#define MEM_TYPE_WC         0x01
+// PAT girişi 1 (PWT=1) reset'te WT; WC'ye çevrilir (girişi 5 de aynı)
+#define PAT_WC_LO           0x00070106
+#define PAT_WC_HI           0x00070106
+
+#define LARGE_PAGE_MASK 0xFFC00000
+#define KERNEL_PDE_START PDE_INDEX(USER_TOP)
+
+static uint32_t kernel_pd[1024] __attribute__((aligned(PAGE_SIZE)));
+static int paging_on = 0;
+static int have_pge = 0;
+static uint32_t* current_pd = kernel_pd;
+static int fb_cache = FB_CACHE_DEFAULT;
+
+// Kernel yarısındaki bir PDE değişince kopyaları güncellenecek directory'ler.
+// Ayrılmış sayfanın struct page'indeki next/prev boşta, liste onlardan geçer;
+// sayı sınırı yok.
+static struct page* directories = 0;
+
+static uint32_t read_cr0() { uint32_t v; __asm__ volatile("mov %%cr0, %0" : "=r"(v)); return v; }
+static uint32_t read_cr4() { uint32_t v; __asm__ volatile("mov %%cr4, %0" : "=r"(v)); return v; }
+static void write_cr0(uint32_t v) { __asm__ volatile("mov %0, %%cr0" : : "r"(v) : "memory"); }
+static void write_cr3(uint32_t v) { __asm__ volatile("mov %0, %%cr3" : : "r"(v) : "memory"); }
+static void write_cr4(uint32_t v) { __asm__ volatile("mov %0, %%cr4" : : "r"(v) : "memory"); }
+
+static uint32_t cpuid_features() {
+    uint32_t a = 1, b, c, d;
+    __asm__ volatile("cpuid" : "+a"(a), "=b"(b), "=c"(c), "=d"(d));
+    return d;
+}
+
+static void rdmsr(uint32_t msr, uint32_t* lo, uint32_t* hi) {
+    __asm__ volatile("rdmsr" : "=a"(*lo), "=d"(*hi) : "c"(msr));
+}
+static void wrmsr(uint32_t msr, uint32_t lo, uint32_t hi) {
+    __asm__ volatile("wrmsr" : : "c"(msr), "a"(lo), "d"(hi) : "memory");
+}
+static void wbinvd() { __asm__ volatile("wbinvd" : : : "memory"); }
+
+// Fiziksel adres genişliği (MTRR mask'ının üst yarısı için)
+static uint32_t phys_addr_bits() {
+    uint32_t a = 0x80000000, b, c, d;
+    __asm__ volatile("cpuid" : "+a"(a), "=b"(b), "=c"(c), "=d"(d));
+    if (a < 0x80000008) return 36;
+    a = 0x80000008;
+    __asm__ volatile("cpuid" : "+a"(a), "=b"(b), "=c"(c), "=d"(d));
+    return a & 0xFF;
+}
+
+// PAT yoksa framebuffer'ı boş bir variable MTRR ile WC yap. MTRR aralığı
+// 2'nin kuvveti ve kendi boyutuna hizalı olmalı; framebuffer'ı kapsayan en
+// küçük böyle blok kullanılır. Intel'in MTRR güncelleme sırası: cache
+// kapalı, wbinvd, MTRR'lar kapalı, yaz, geri aç.
+static int mtrr_set_wc(uint32_t phys, uint32_t size) {
+    uint32_t cap, unused;
+    rdmsr(MSR_MTRRCAP, &cap, &unused);
+    if (!(cap & MTRRCAP_WC)) return 0;
+
+    uint32_t block = PAGE_SIZE;
+    while (block && block < size) block <<= 1;
+    while (block && (phys & ~(block - 1)) + block < phys + size) block <<= 1;
+    if (!block) return 0;
+    uint32_t base = phys & ~(block - 1);
+
+    int slot = -1;
+    for (uint32_t i = 0; i < (cap & 0xFF); i++) {
+        uint32_t lo, hi;
+        rdmsr(MSR_MTRR_PHYSMASK0 + i * 2, &lo, &hi);
+        if (!(lo & MTRR_VALID)) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) return 0;
+
+    uint32_t bits = phys_addr_bits();
+    uint32_t mask_hi = bits > 32 ? (1u << (bits - 32)) - 1 : 0;
+    uint32_t def_lo, def_hi;
+    uint32_t cr0 = read_cr0();
+    write_cr0((cr0 | CR0_CD) & ~CR0_NW);
+    wbinvd();
+    rdmsr(MSR_MTRR_DEF_TYPE, &def_lo, &def_hi);
+    wrmsr(MSR_MTRR_DEF_TYPE, def_lo & ~MTRR_ENABLE, def_hi);
+    wrmsr(MSR_MTRR_PHYSBASE0 + slot * 2, base | MEM_TYPE_WC, 0);
+    wrmsr(MSR_MTRR_PHYSMASK0 + slot * 2, ~(block - 1) | MTRR_VALID, mask_hi);
+    wbinvd();
+    wrmsr(MSR_MTRR_DEF_TYPE, def_lo, def_hi);
+    write_cr0(cr0);
+    return 1;
+}
+
+// Framebuffer'ı write-combining yap: ardışık piksel yazıları tek tek
+// uncached store yerine 64 byte'lık burst'lere birleşir. Tercih PAT (sadece
+// bu eşlemenin cache tipi değişir), yoksa MTRR. Eşlemede kullanılacak cache
+// bitleri döner.
+static uint32_t fb_setup_cache(uint32_t features, uint32_t phys, uint32_t size) {
+    if (features & CPUID_PAT) {
+        wbinvd();
+        wrmsr(MSR_PAT, PAT_WC_LO, PAT_WC_HI);
+        fb_cache = FB_CACHE_PAT;
+        return PTE_PWT;
+    }
+    if ((features & CPUID_MTRR) && mtrr_set_wc(phys, size)) {
+        fb_cache = FB_CACHE_MTRR;
+    }
+    return 0;
+}
+
+static uint32_t kernel_flags() {
+    return PTE_PRESENT | PTE_WRITE | (have_pge ? PTE_GLOBAL : 0);
+}
+
+// Fiziksel [phys, phys+size) aralığını virt'ten itibaren 4MB sayfalarla eşle
+static void map_large(uint32_t virt, uint32_t phys, uint32_t size, uint32_t flags) {
+    uint32_t addr = phys & LARGE_PAGE_MASK;
+    uint32_t end = phys + size;
+    if (end < phys) end = 0xFFFFFFFF;
+    while (addr < end && virt >= KERNEL_PDE_START << 22) {
+        kernel_pd[PDE_INDEX(virt)] = addr | flags | PTE_LARGE;
+        if (addr + LARGE_PAGE_SIZE < addr || virt + LARGE_PAGE_SIZE < virt) break;
+        addr += LARGE_PAGE_SIZE;
+        virt += LARGE_PAGE_SIZE;
+    }
+}
+
+// PSE yoksa RAM'i 4KB tablolarla eşleyecek bellek yok; boot directory'sinin
+// 4MB'ı kernel'e yetmez. Durmadan önce sebebi ekrana yaz: kullanılmayan
+// kernel_pd, boot directory'sinde framebuffer'ın ilk 4MB'ını eşleyen page
+// table olur.
+static void paging_fatal_no_pse() {
+    if (framebuffer) {
+        uint32_t cr3;
+        __asm__ volatile("mov %%cr3, %0" : "=r"(cr3));
+        uint32_t* boot_pd = (uint32_t*)P2V(cr3 & PTE_ADDR_MASK);
+        uint32_t base = framebuffer & LARGE_PAGE_MASK;
+        for (uint32_t i = 0; i < 1024; i++) {
+            kernel_pd[i] = (base + (i << PAGE_SHIFT)) | PTE_PRESENT | PTE_WRITE;
+        }
+        boot_pd[PDE_INDEX(FB_VIRT_BASE)] = V2P(kernel_pd) | PTE_PRESENT | PTE_WRITE;
+        write_cr3(cr3);
+        framebuffer = FB_VIRT_BASE + (framebuffer & ~LARGE_PAGE_MASK);
+    }
+    print_color("FATAL: CPU lacks PSE (4MB pages), kernel cannot map memory. System halted.\n",
+                VGA_COLOR_LIGHT_RED);
+    for (;;) __asm__ volatile("cli; hlt");
+}
+
+// boot.asm paging'i ilk 4MB'lık geçici bir directory ile açmış olarak gelir
+void paging_init() {
+    uint32_t features = cpuid_features();
+    if (!(features & CPUID_PSE)) paging_fatal_no_pse();
+    have_pge = (features & CPUID_PGE) != 0;
+    uint32_t kflags = kernel_flags();
+
+    // Heap, buddy'nin dağıttığı bütün RAM ve kernel image'ın kendisi.
+    // User penceresi (0. sayfa dahil) boş: NULL dereference page fault verir
+    map_large(PHYS_MAP_BASE, 0, PMM_PHYS_LIMIT, kflags);
+
+    // Framebuffer boot.asm'in bulduğu fiziksel adresten FB_VIRT_BASE'e taşınır
+    if (framebuffer) {
+        uint32_t fb_phys = framebuffer;
+        uint32_t fb_size = fb_pitch * fb_height;
+        uint32_t cache = fb_setup_cache(features, fb_phys, fb_size);
+        map_large(FB_VIRT_BASE, fb_phys, fb_size, kflags | cache);
+        framebuffer = FB_VIRT_BASE + (fb_phys & ~LARGE_PAGE_MASK);
+    }
+
+    write_cr4(read_cr4() | CR4_PSE);
+    write_cr3(V2P(kernel_pd));
+    // WP: kernel de read-only sayfalara yazamasın (COW için gerekli)
+    write_cr0(read_cr0() | CR0_PG | CR0_WP);
+    if (have_pge) write_cr4(read_cr4() | CR4_PGE);
+    paging_on = 1;
+}
+
+uint32_t* paging_kernel_directory() {
+    return kernel_pd;
+}
+
+uint32_t* paging_create_directory() {
+    uint32_t phys = pmm_alloc_pages_zeroed(1);
+    if (!phys) return 0;
+
+    // User yarısı boş, kernel yarısı ortak
+    uint32_t* pd = (uint32_t*)P2V(phys);
+    for (uint32_t i = KERNEL_PDE_START; i < 1024; i++) {
+        pd[i] = kernel_pd[i];
+    }
+    struct page* pg = pmm_page(phys);
+    pg->prev = 0;
+    pg->next = directories;
+    if (directories) directories->prev = pg;
+    directories = pg;
+    return pd;
+}
+
+// User sayfasının frame'ini bırak: ödünç sayfa dokunulmaz, COW ile
+// paylaşılan frame son eşleme gidince boşalır
+static void release_frame(uint32_t entry) {
+    if (!(entry & PTE_BORROWED)) pmm_page_put(entry & PTE_ADDR_MASK);
+}
+
+// Frame başka bir address space ile (ya da ramdisk'le) paylaşılıyor mu
+static int frame_shared(uint32_t entry) {
+    if (entry & PTE_BORROWED) return 1;
+    struct page* pg = pmm_page(entry & PTE_ADDR_MASK);
+    return pg && pg->refs;
+}
+
+// User penceresindeki bütün sayfaları, page table'ları ve directory'yi boşalt
+void paging_destroy_directory(uint32_t* pd) {
+    if (!pd || pd == kernel_pd) return;
+    if (current_pd == pd) paging_switch(kernel_pd);
+
+    for (uint32_t i = 0; i < KERNEL_PDE_START; i++) {
+        uint32_t pde = pd[i];
+        if (!(pde & PTE_PRESENT) || (pde & PTE_LARGE)) continue;
+        uint32_t* pt = (uint32_t*)P2V(pde & PTE_ADDR_MASK);
+        for (uint32_t j = 0; j < 1024; j++) {
+            if (pt[j] & PTE_PRESENT) release_frame(pt[j]);
+        }
+        pmm_free_pages(pde & PTE_ADDR_MASK, 1);
+    }
+    struct page* pg = pmm_page(V2P(pd));
+    if (pg->prev) pg->prev->next = pg->next;
+    else directories = pg->next;
+    if (pg->next) pg->next->prev = pg->prev;
+    pg->next = 0;
+    pg->prev = 0;
+    pmm_free_pages(V2P(pd), 1);
+}
+
+void paging_switch(uint32_t* pd) {
+    if (!paging_on) return;
+    current_pd = pd;
+    write_cr3(V2P(pd));
+}
+
+uint32_t* paging_current_directory() {
+    return current_pd;
+}
+
+// Kernel yarısındaki PDE değişikliğini bütün process directory'lerine yay
+static void sync_kernel_pde(uint32_t index) {
+    for (struct page* pg = directories; pg; pg = pg->next) {
+        uint32_t* pd = (uint32_t*)P2V(pmm_page_addr(pg));
+        pd[index] = kernel_pd[index];
+    }
+}
+
+void paging_flush(uint32_t virt) {
+    __asm__ volatile("invlpg (%0)" : : "r"(virt) : "memory");
+}
+
+void paging_flush_all() {
+    if (have_pge) {
+        // Global girişler sadece PGE kapatılıp açılınca düşer
+        uint32_t cr4 = read_cr4();
+        write_cr4(cr4 & ~CR4_PGE);
+        write_cr4(cr4);
+    } else {
+        uint32_t cr3;
+        __asm__ volatile("mov %%cr3, %0" : "=r"(cr3));
+        write_cr3(cr3);
+    }
+}
+
+int paging_fb_cache_mode() {
+    return fb_cache;
+}
+
+// Framebuffer PDE'lerinin cache tipini değiştir: wc 0 ise strong UC (PCD|PWT),
+// değilse paging_init'in kurduğu WC. Benchmark'ın önce/sonra ölçümü için.
+void paging_fb_set_write_combining(int wc) {
+    if (!paging_on || !framebuffer) return;
+    uint32_t cache = !wc ? PTE_PCD | PTE_PWT : fb_cache == FB_CACHE_PAT ? PTE_PWT : 0;
+    uint32_t end = framebuffer + fb_pitch * fb_height;
+    for (uint32_t va = framebuffer & LARGE_PAGE_MASK; va < end && va >= FB_VIRT_BASE; va += LARGE_PAGE_SIZE) {
+        uint32_t index = PDE_INDEX(va);
+        kernel_pd[index] = (kernel_pd[index] & ~(PTE_PCD | PTE_PWT)) | cache;
+        sync_kernel_pde(index);
+        if (va + LARGE_PAGE_SIZE < va) break;
+    }
+    // Eski tipte yazılmış satırlar tip değişmeden boşaltılsın
+    wbinvd();
+    paging_flush_all();
+}
+
+// 4MB'lık PDE'yi aynı eşlemeyi yapan 1024 girişlik page table'a çevir (TLB flush çağıranda)
+static int split_large(uint32_t* pde) {
+    uint32_t pt = pmm_alloc_pages(1);
+    if (!pt) return -1;
+
+    uint32_t* table = (uint32_t*)P2V(pt);
+    uint32_t base = *pde & LARGE_PAGE_MASK;
+    uint32_t flags = *pde & PTE_FLAGS_MASK & ~PTE_LARGE;
+    for (uint32_t i = 0; i < 1024; i++) {
+        table[i] = (base + (i << PAGE_SHIFT)) | flags;
+    }
+    *pde = pt | PTE_PRESENT | PTE_WRITE | (flags & PTE_USER);
+    return 0;
+}
+
+// virt'i kapsayan page table; büyük sayfa ise bölünür, yoksa create ile ayrılır
+static uint32_t* page_table_for(uint32_t* pd, uint32_t virt, uint32_t flags, int create) {
+    uint32_t index = PDE_INDEX(virt);
+    int shared = index >= KERNEL_PDE_START;
+    // Ortak kernel girişleri sadece kernel_pd üzerinden değişir
+    if (shared) pd = kernel_pd;
+
+    uint32_t* pde = &pd[index];
+    if (*pde & PTE_PRESENT) {
+        if (*pde & PTE_LARGE) {
+            if (split_large(pde) < 0) return 0;
+            if (shared) sync_kernel_pde(index);
+            // Eski büyük sayfa global olabilir, CR3 yüklemesi yetmez
+            paging_flush_all();
+        }
+        if ((flags & PTE_USER) && !shared) *pde |= PTE_USER;
+        return (uint32_t*)P2V(*pde & PTE_ADDR_MASK);
+    }
+    if (!create) return 0;
+
+    uint32_t pt = pmm_alloc_pages_zeroed(1);
+    if (!pt) return 0;
+    *pde = pt | PTE_PRESENT | PTE_WRITE | (shared ? 0 : (flags & PTE_USER));
+    if (shared) sync_kernel_pde(index);
+    return (uint32_t*)P2V(pt);
+}
+
+int paging_map(uint32_t* pd, uint32_t virt, uint32_t phys, uint32_t flags) {
+    uint32_t* pt = page_table_for(pd, virt, flags, 1);
+    if (!pt) return -1;
+    pt[PTE_INDEX(virt)] = (phys & PTE_ADDR_MASK) | (flags & PTE_FLAGS_MASK & ~PTE_LARGE) | PTE_PRESENT;
+    paging_flush(virt);
+    return 0;
+}
+
+int paging_map_range(uint32_t* pd, uint32_t virt, uint32_t phys, uint32_t size, uint32_t flags) {
+    for (uint32_t off = 0; off < size; off += PAGE_SIZE) {
+        if (paging_map(pd, virt + off, phys + off, flags) < 0) {
+            // Yarım kalan eşlemeyi geri al
+            while (off) {
+                off -= PAGE_SIZE;
+                paging_unmap(pd, virt + off);
+            }
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Eşlemeyi kaldırır, eski fiziksel adresi döner (boşaltmak çağıranın işi)
+uint32_t paging_unmap(uint32_t* pd, uint32_t virt) {
+    uint32_t* pt = page_table_for(pd, virt, 0, 0);
+    if (!pt) return 0;
+    uint32_t entry = pt[PTE_INDEX(virt)];
+    if (!(entry & PTE_PRESENT)) return 0;
+    pt[PTE_INDEX(virt)] = 0;
+    paging_flush(virt);
+    return entry & PTE_ADDR_MASK;
+}
+
+// İzinleri değiştirir; PTE_BORROWED korunur, paylaşılan frame'e yazma izni
+// PTE_WRITE yerine PTE_COW olarak verilir
+int paging_protect(uint32_t* pd, uint32_t virt, uint32_t flags) {
+    uint32_t* pt = page_table_for(pd, virt, flags, 0);
+    if (!pt) return -1;
+    uint32_t entry = pt[PTE_INDEX(virt)];
+    if (!(entry & PTE_PRESENT)) return -1;
+    flags = (flags & PTE_FLAGS_MASK & ~(PTE_LARGE | PTE_BORROWED | PTE_COW)) | (entry & PTE_BORROWED);
+    if ((flags & PTE_WRITE) && frame_shared(entry)) flags = (flags & ~PTE_WRITE) | PTE_COW;
+    pt[PTE_INDEX(virt)] = (entry & PTE_ADDR_MASK) | flags | PTE_PRESENT;
+    paging_flush(virt);
+    return 0;
+}
+
+// virt'in 4KB'lık girişi (adres | bayraklar), eşli değilse 0. Büyük sayfalar bölünmez.
+uint32_t paging_lookup(uint32_t* pd, uint32_t virt) {
+    uint32_t pde = pd[PDE_INDEX(virt)];
+    if (!(pde & PTE_PRESENT)) return 0;
+    if (pde & PTE_LARGE) {
+        return ((pde & LARGE_PAGE_MASK) + (virt & ~LARGE_PAGE_MASK & PTE_ADDR_MASK))
+             | (pde & PTE_FLAGS_MASK & ~PTE_LARGE);
+    }
+    uint32_t entry = ((uint32_t*)P2V(pde & PTE_ADDR_MASK))[PTE_INDEX(virt)];
+    return (entry & PTE_PRESENT) ? entry : 0;
+}
+
+static int user_range_ok(uint32_t virt, uint32_t size) {
+    return virt >= USER_BASE && virt + size <= USER_TOP && virt + size >= virt;
+}
+
+// Zaten eşli sayfalar olduğu gibi bırakılır (aynı sayfayı paylaşan ELF segmentleri)
+int paging_alloc_range(uint32_t* pd, uint32_t virt, uint32_t size, uint32_t flags) {
+    if (!user_range_ok(virt, size)) return -1;
+    for (uint32_t off = 0; off < size; off += PAGE_SIZE) {
+        if (paging_lookup(pd, virt + off)) continue;
+        uint32_t phys = pmm_alloc_pages_zeroed(1);
+        if (!phys) return -1;
+        if (paging_map(pd, virt + off, phys, flags | PTE_USER) < 0) {
+            pmm_free_pages(phys, 1);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void paging_free_range(uint32_t* pd, uint32_t virt, uint32_t size) {
+    if (!user_range_ok(virt, size)) return;
+    for (uint32_t off = 0; off < size; off += PAGE_SIZE) {
+        uint32_t entry = paging_lookup(pd, virt + off);
+        if (!entry) continue;
+        paging_unmap(pd, virt + off);
+        release_frame(entry);
+    }
+}
+
+// start'tan itibaren size byte'lık eşlenmemiş user aralığı, yoksa 0
+uint32_t paging_find_free(uint32_t* pd, uint32_t start, uint32_t size) {
+    uint32_t run = start, virt = start;
+    while (user_range_ok(run, size)) {
+        if (virt - run >= size) return run;
+        if (!(pd[PDE_INDEX(virt)] & PTE_PRESENT)) {
+            // Boş PDE: 4MB'ın tamamı boş
+            virt = (virt & LARGE_PAGE_MASK) + LARGE_PAGE_SIZE;
+            continue;
+        }
+        if (paging_lookup(pd, virt)) {
+            run = virt + PAGE_SIZE;
+        }
+        virt += PAGE_SIZE;
+    }
+    return 0;
+}
+
+// Child'a kendi page table'ları verilir, frame'ler paylaşılır: yazılabilir
+// sayfalar iki tarafta da read-only + PTE_COW olur. Bellek kopyalanmaz,
+// maliyet dolu page table başına bir sayfa. Yarıda kalırsa dst'yi
+// paging_destroy_directory temizler (aldığı referansları geri verir).
+int paging_clone_user(uint32_t* dst, uint32_t* src) {
+    for (uint32_t i = 0; i < KERNEL_PDE_START; i++) {
+        uint32_t pde = src[i];
+        if (!(pde & PTE_PRESENT) || (pde & PTE_LARGE)) continue;
+
+        uint32_t pt = pmm_alloc_pages_zeroed(1);
+        if (!pt) return -1;
+        dst[i] = pt | (pde & PTE_FLAGS_MASK);
+        uint32_t* dpt = (uint32_t*)P2V(pt);
+
+        uint32_t* spt = (uint32_t*)P2V(pde & PTE_ADDR_MASK);
+        for (uint32_t j = 0; j < 1024; j++) {
+            uint32_t entry = spt[j];
+            if (!(entry & PTE_PRESENT)) continue;
+            if (!(entry & PTE_BORROWED)) {
+                pmm_page_get(entry & PTE_ADDR_MASK);
+                if (entry & PTE_WRITE) {
+                    entry = (entry & ~PTE_WRITE) | PTE_COW;
+                    spt[j] = entry;
+                }
+            }
+            dpt[j] = entry & ~(PTE_ACCESSED | PTE_DIRTY);
+        }
+    }
+    // src'nin yazılabilir girişleri read-only oldu; user sayfaları global değil
+    if (src == current_pd) write_cr3(V2P(current_pd));
+    return 0;
+}
+
+// COW fault'u ya da ödünç sayfaya yazma: son paylaşan ise sadece yazma izni
+// geri gelir, değilse frame kopyalanır
+int paging_unshare(uint32_t* pd, uint32_t virt) {
+    uint32_t* pt = page_table_for(pd, virt, 0, 0);
+    if (!pt) return -1;
+    uint32_t entry = pt[PTE_INDEX(virt)];
+    if (!(entry & PTE_PRESENT) || !(entry & (PTE_COW | PTE_BORROWED))) return -1;
+
+    uint32_t flags = entry & PTE_FLAGS_MASK & ~(PTE_COW | PTE_BORROWED);
+    if (entry & PTE_COW) flags |= PTE_WRITE;
+    uint32_t phys = entry & PTE_ADDR_MASK;
+    if (frame_shared(entry)) {
+        uint32_t copy = pmm_alloc_pages(1);
+        if (!copy) return -1;
+        z_memcpy(P2V(copy), P2V(phys), PAGE_SIZE);
+        release_frame(entry);
+        phys = copy;
+    }
+    pt[PTE_INDEX(virt)] = phys | flags;
+    paging_flush(virt);
+    return 0;
+}
+
+// Page fault (int 14). Çözülen fault için 1 döner, iret aynı komutu tekrar dener.
+int paging_fault(struct regs* r) {
+    uint32_t addr;
+    __asm__ volatile("mov %%cr2, %0" : "=r"(addr));
+
+    // User penceresinde henüz doldurulmamış bir sayfa mı (demand paging)
+    if (vm_fault(addr, r->err_code)) return 1;
+
+    if (addr >= USER_STACK_TOP - USER_STACK_SIZE && addr < USER_STACK_TOP - USER_STACK_SIZE + PAGE_SIZE) {
+        z_printf("\nUser stack overflow (limit %u KB)", USER_STACK_SIZE / 1024);
+    }
+    z_printf("\nPage fault at 0x%x (eip 0x%x, %s %s%s)\n", addr, r->eip,
+             (r->err_code & PF_PRESENT) ? "protection" : "not present",
+             (r->err_code & PF_WRITE) ? "write" : "read",
+             (r->err_code & PF_USER) ? ", user" : "");
+
+    // Program çalışmıyorsa fault kernel'in kendisinde: dönülecek yer yok
+    extern void* elf_exit_label_addr;
+    if (!elf_exit_label_addr) {
+        z_printf("Kernel page fault, system halted\n");
+        while (1) { __asm__ volatile("cli; hlt"); }
+    }
+    return 0;
+}
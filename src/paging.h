@@ -0,0 +1,103 @@
+#ifndef PAGING_H
+#define PAGING_H
+
+// Kendi typedef'lerimiz
+typedef unsigned char uint8_t;
+typedef unsigned short uint16_t;
+typedef unsigned int uint32_t;
+
+struct regs;
+
+// Page directory / page table entry bitleri (32-bit, PAE yok)
+#define PTE_PRESENT     0x001
+#define PTE_WRITE       0x002
+#define PTE_USER        0x004
+#define PTE_PWT         0x008
+#define PTE_PCD         0x010
+#define PTE_ACCESSED    0x020
+#define PTE_DIRTY       0x040
+#define PTE_LARGE       0x080   // Sadece PDE'de: 4MB PSE sayfası
+#define PTE_GLOBAL      0x100   // CR4.PGE açıkken CR3 yüklemesinde TLB'den düşmez
+#define PTE_BORROWED    0x200   // Yazılım biti: sayfa address space'in değil (ör. ramdisk), boşaltılmaz
+#define PTE_COW         0x400   // Yazılım biti: yazılabilir ama paylaşılıyor, ilk yazmada kopyalanır
+#define PTE_FLAGS_MASK  0xFFF
+#define PTE_ADDR_MASK   0xFFFFF000
+
+// Page fault error code bitleri
+#define PF_PRESENT      0x1     // 0: sayfa yok, 1: koruma ihlali
+#define PF_WRITE        0x2
+#define PF_USER         0x4
+
+#define LARGE_PAGE_SIZE 0x400000
+#define PDE_INDEX(v)    ((uint32_t)(v) >> 22)
+#define PTE_INDEX(v)    (((uint32_t)(v) >> 12) & 0x3FF)
+
+// Sanal adres düzeni:
+//   0x00000000-0x0000FFFF  boş (NULL ve küçük offset'li dereference'lar fault versin)
+//   0x00010000-0xBFFFDFFF  user penceresi, her process'in kendi page table'ları
+//                          (ld -Ttext=0x400000 header'ları 0x3FF000'e koyuyor)
+//   0xBFFFE000-0xBFFFFFFF  vDSO: veri sayfası + kod sayfası, bütün process'lerde
+//                          aynı frame'ler, read-only (vdso.h)
+//   0xC0000000-0xEFFFFFFF  bütün RAM'in doğrudan eşlemesi (PMM_PHYS_LIMIT kadar);
+//                          kernel image 0xC0100000'da (linker.ld KERNEL_VIRT_BASE)
+//   0xF0000000-0xF7FFFFFF  framebuffer
+//   0xF8000000-0xFBFFFFFF  kernel stack'leri: 4KB sayfalarla eşlenir, her
+//                          stack'in altında eşlenmemiş bir guard sayfası var
+// 0xC0000000 üstü global ve bütün directory'lerde ortak. User stack'i
+// USER_STACK_TOP'tan aşağı dokunuldukça büyür (vm.c), en fazla
+// USER_STACK_SIZE; en alttaki sayfası guard, hiç eşlenmez.
+#define USER_BASE       0x00010000
+#define USER_TOP        0xC0000000
+#define VDSO_SIZE       0x00002000
+#define VDSO_BASE       (USER_TOP - VDSO_SIZE)
+#define USER_STACK_SIZE 0x00100000
+#define USER_STACK_TOP  VDSO_BASE   // Stack vDSO'nun hemen altından aşağı büyür
+#define USER_MMAP_BASE  0x40000000  // Adres verilmeyen mmap'ler buradan aranır
+#define PHYS_MAP_BASE   0xC0000000
+#define FB_VIRT_BASE    0xF0000000
+#define KSTACK_AREA_BASE 0xF8000000
+#define KSTACK_AREA_SIZE 0x04000000
+
+// pmm'in verdiği fiziksel adresle kernel pointer'ı arasında çeviri
+#define P2V(pa)         ((void*)((uint32_t)(pa) + PHYS_MAP_BASE))
+#define V2P(va)         ((uint32_t)(va) - PHYS_MAP_BASE)
+
+// Framebuffer'ın cache tipi (paging_fb_cache_mode)
+#define FB_CACHE_DEFAULT 0      // Firmware'in bıraktığı tip (genelde UC)
+#define FB_CACHE_PAT     1      // PAT girişi 1 WC, eşleme PWT ile
+#define FB_CACHE_MTRR    2      // Variable MTRR ile WC
+
+// Paging fonksiyonları
+void paging_init();
+uint32_t* paging_kernel_directory();
+int paging_fb_cache_mode();
+void paging_fb_set_write_combining(int wc);
+
+// Process address space'leri: kernel yarısı ortak, user penceresi boş başlar
+uint32_t* paging_create_directory();
+void paging_destroy_directory(uint32_t* pd);
+void paging_switch(uint32_t* pd);
+uint32_t* paging_current_directory();
+
+// 4KB granülerlikte eşleme; gerekiyorsa 4MB PSE eşlemesi page table'a bölünür
+int paging_map(uint32_t* pd, uint32_t virt, uint32_t phys, uint32_t flags);
+int paging_map_range(uint32_t* pd, uint32_t virt, uint32_t phys, uint32_t size, uint32_t flags);
+uint32_t paging_unmap(uint32_t* pd, uint32_t virt);
+int paging_protect(uint32_t* pd, uint32_t virt, uint32_t flags);
+uint32_t paging_lookup(uint32_t* pd, uint32_t virt);
+
+// User penceresinde sıfırlanmış sayfa ayırıp eşleme / eşlemeyi kaldırıp boşaltma
+int paging_alloc_range(uint32_t* pd, uint32_t virt, uint32_t size, uint32_t flags);
+void paging_free_range(uint32_t* pd, uint32_t virt, uint32_t size);
+uint32_t paging_find_free(uint32_t* pd, uint32_t start, uint32_t size);
+
+// Fork: src'nin user penceresi dst'ye page table kopyasıyla, copy-on-write paylaşılır
+int paging_clone_user(uint32_t* dst, uint32_t* src);
+// COW/ödünç sayfayı address space'e özel, yazılabilir kopyaya çevir
+int paging_unshare(uint32_t* pd, uint32_t virt);
+
+void paging_flush(uint32_t virt);
+void paging_flush_all();
+int paging_fault(struct regs* r);
+
+#endif
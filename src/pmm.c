@@ -0,0 +1,438 @@
+#include "pmm.h"
+#include "paging.h"
+
+// Physical memory manager: multiboot2 memory map'inden beslenen buddy allocator.
+// Her fiziksel sayfanın bir struct page kaydı var; boş block'lar order'a göre
+// çift yönlü listelerde tutulur, buddy'ler free sırasında birleştirilir.
+
+// boot.asm'in multiboot2 tag listesinden bulduğu adresler
+extern uint32_t multiboot_info;
+extern uint32_t mb_mmap_tag;
+
+// linker.ld'den
+extern char _kernel_start[];
+extern char _kernel_end[];
+
+#define MMAP_TYPE_AVAILABLE 1
+#define MAX_REGIONS 32
+#define MAX_RESERVED 8
+
+// Memory map yoksa eski sabit heap aralığına düş
+#define FALLBACK_START 0x1000000
+#define FALLBACK_SIZE  0x10000000
+
+struct mb_mmap_entry {
+    uint32_t base_lo, base_hi;
+    uint32_t len_lo, len_hi;
+    uint32_t type;
+    uint32_t reserved;
+};
+
+struct phys_range {
+    uint32_t start;
+    uint32_t end;
+};
+
+static struct phys_range regions[MAX_REGIONS];
+static int region_count = 0;
+static struct phys_range reserved[MAX_RESERVED];
+static int reserved_count = 0;
+
+static struct page* pages = 0;
+static uint32_t max_pfn = 0;
+static struct page* free_lists[PMM_MAX_ORDER + 1];
+static uint32_t total_pages = 0;
+static uint32_t free_pages = 0;
+
+// Boşta sıfırlama: kaldığı yer ve yapacak iş kalmadı bayrağı
+static uint32_t zero_cursor = 0;
+static int zero_scan_done = 0;
+
+#define PAGE_ALIGN_UP(x)   (((x) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))
+#define PAGE_ALIGN_DOWN(x) ((x) & ~(PAGE_SIZE - 1))
+
+static void add_region(uint32_t start, uint32_t end) {
+    // Pencere dışındaki RAM'e kernel erişemez, dağıtılmamalı
+    if (end > PMM_PHYS_LIMIT) end = PMM_PHYS_LIMIT;
+    start = PAGE_ALIGN_UP(start);
+    end = PAGE_ALIGN_DOWN(end);
+    if (end <= start || region_count >= MAX_REGIONS) return;
+    regions[region_count].start = start;
+    regions[region_count].end = end;
+    region_count++;
+}
+
+static void add_reserved(uint32_t start, uint32_t end) {
+    if (reserved_count >= MAX_RESERVED) return;
+    reserved[reserved_count].start = PAGE_ALIGN_DOWN(start);
+    reserved[reserved_count].end = PAGE_ALIGN_UP(end);
+    reserved_count++;
+}
+
+// Multiboot2 mmap tag'inden kullanılabilir bölgeleri topla (PMM_PHYS_LIMIT üstü yok sayılır)
+static void parse_memory_map() {
+    if (!mb_mmap_tag) {
+        add_region(FALLBACK_START, FALLBACK_START + FALLBACK_SIZE);
+        return;
+    }
+
+    uint32_t tag = (uint32_t)P2V(mb_mmap_tag);
+    uint32_t tag_size = *(uint32_t*)(tag + 4);
+    uint32_t entry_size = *(uint32_t*)(tag + 8);
+    uint32_t off = 16;
+    while (off + entry_size <= tag_size) {
+        struct mb_mmap_entry* e = (struct mb_mmap_entry*)(tag + off);
+        off += entry_size;
+        if (e->type != MMAP_TYPE_AVAILABLE || e->base_hi != 0) continue;
+
+        uint32_t start = e->base_lo;
+        uint32_t end = start + e->len_lo;
+        if (e->len_hi != 0 || end < start) end = 0xFFFFF000;
+        add_region(start, end);
+    }
+}
+
+static int overlaps_reserved(uint32_t start, uint32_t end, uint32_t* skip_to) {
+    for (int i = 0; i < reserved_count; i++) {
+        if (start < reserved[i].end && end > reserved[i].start) {
+            *skip_to = reserved[i].end;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// struct page dizisini rezerve alanlara değmeyen ilk yere koy
+static uint32_t place_page_array(uint32_t bytes) {
+    for (int i = 0; i < region_count; i++) {
+        uint32_t start = regions[i].start;
+        uint32_t skip;
+        while (start + bytes <= regions[i].end && start + bytes > start) {
+            if (!overlaps_reserved(start, start + bytes, &skip)) return start;
+            start = PAGE_ALIGN_UP(skip);
+        }
+    }
+    return 0;
+}
+
+static void list_push(uint32_t order, struct page* p) {
+    p->prev = 0;
+    p->next = free_lists[order];
+    if (free_lists[order]) free_lists[order]->prev = p;
+    free_lists[order] = p;
+}
+
+static void list_remove(uint32_t order, struct page* p) {
+    if (p->prev) p->prev->next = p->next;
+    else free_lists[order] = p->next;
+    if (p->next) p->next->prev = p->prev;
+    p->next = 0;
+    p->prev = 0;
+}
+
+// Block'u buddy'leriyle birleştirerek free listesine koy
+static void free_block(uint32_t pfn, uint32_t order) {
+    free_pages += 1 << order;
+    while (order < PMM_MAX_ORDER) {
+        uint32_t buddy = pfn ^ (1 << order);
+        if (buddy >= max_pfn) break;
+        struct page* bp = &pages[buddy];
+        if (!(bp->flags & PG_FREE) || bp->order != order) break;
+        list_remove(order, bp);
+        bp->flags &= ~PG_FREE;
+        pfn &= ~(1 << order);
+        order++;
+    }
+    pages[pfn].flags |= PG_FREE;
+    pages[pfn].order = order;
+    list_push(order, &pages[pfn]);
+}
+
+// [start, end) aralığındaki sayfaları en büyük hizalı block'lar halinde geri koy
+static void release_range(uint32_t start_pfn, uint32_t end_pfn) {
+    uint32_t pfn = start_pfn;
+    while (pfn < end_pfn) {
+        uint32_t order = 0;
+        while (order < PMM_MAX_ORDER &&
+               (pfn & ((2u << order) - 1)) == 0 &&
+               pfn + (2u << order) <= end_pfn) {
+            order++;
+        }
+        free_block(pfn, order);
+        pfn += 1 << order;
+    }
+}
+
+static void free_range(uint32_t start_pfn, uint32_t end_pfn) {
+    for (uint32_t pfn = start_pfn; pfn < end_pfn; pfn++) {
+        pages[pfn].flags = 0;
+    }
+    total_pages += end_pfn - start_pfn;
+    release_range(start_pfn, end_pfn);
+}
+
+// Bölgeden rezerve aralıkları çıkararak kalanları buddy'ye ver
+static void add_free_region(uint32_t start, uint32_t end, int first_reserved) {
+    for (int i = first_reserved; i < reserved_count; i++) {
+        if (start < reserved[i].end && end > reserved[i].start) {
+            if (start < reserved[i].start) add_free_region(start, reserved[i].start, i + 1);
+            if (end > reserved[i].end) add_free_region(reserved[i].end, end, i + 1);
+            return;
+        }
+    }
+    if (end > start) free_range(start >> PAGE_SHIFT, end >> PAGE_SHIFT);
+}
+
+void pmm_init() {
+    region_count = 0;
+    reserved_count = 0;
+    parse_memory_map();
+
+    // İlk 1MB (BIOS, VGA, TSS stack), kernel image, multiboot bilgisi
+    add_reserved(0, 0x100000);
+    add_reserved(V2P(_kernel_start), V2P(_kernel_end));
+    if (multiboot_info) {
+        add_reserved(multiboot_info, multiboot_info + *(uint32_t*)P2V(multiboot_info));
+    }
+
+    max_pfn = 0;
+    for (int i = 0; i < region_count; i++) {
+        if ((regions[i].end >> PAGE_SHIFT) > max_pfn) max_pfn = regions[i].end >> PAGE_SHIFT;
+    }
+
+    uint32_t array_bytes = PAGE_ALIGN_UP(max_pfn * sizeof(struct page));
+    uint32_t array_addr = place_page_array(array_bytes);
+    if (!array_addr) return;
+    pages = (struct page*)P2V(array_addr);
+    add_reserved(array_addr, array_addr + array_bytes);
+
+    for (uint32_t pfn = 0; pfn < max_pfn; pfn++) {
+        pages[pfn].next = 0;
+        pages[pfn].prev = 0;
+        pages[pfn].flags = PG_RESERVED;
+        pages[pfn].order = 0;
+        pages[pfn].refs = 0;
+    }
+    for (int i = 0; i <= PMM_MAX_ORDER; i++) free_lists[i] = 0;
+    total_pages = 0;
+    free_pages = 0;
+
+    for (int i = 0; i < region_count; i++) {
+        add_free_region(regions[i].start, regions[i].end, 0);
+    }
+}
+
+static inline void zero_page(uint32_t addr) {
+    uint32_t count = PAGE_SIZE / 4;
+    uint32_t va = (uint32_t)P2V(addr);
+    __asm__ volatile("rep stosl" : "+D"(va), "+c"(count) : "a"(0) : "memory");
+}
+
+// PG_ZERO ayrılan sayfalarda bayat kalmasın diye temizle
+static void clear_zero_flags(uint32_t addr, uint32_t npages) {
+    uint32_t pfn = addr >> PAGE_SHIFT;
+    for (uint32_t i = 0; i < npages; i++) pages[pfn + i].flags &= ~PG_ZERO;
+}
+
+static uint32_t alloc_block(uint32_t order) {
+    if (order > PMM_MAX_ORDER) return 0;
+
+    uint32_t k = order;
+    while (k <= PMM_MAX_ORDER && !free_lists[k]) k++;
+    if (k > PMM_MAX_ORDER) return 0;
+
+    struct page* p = free_lists[k];
+    list_remove(k, p);
+    p->flags &= ~PG_FREE;
+    uint32_t pfn = p - pages;
+
+    // Fazla yarıları alt order'lara geri koy
+    while (k > order) {
+        k--;
+        struct page* half = &pages[pfn + (1 << k)];
+        half->flags |= PG_FREE;
+        half->order = k;
+        list_push(k, half);
+    }
+
+    free_pages -= 1 << order;
+    return pfn << PAGE_SHIFT;
+}
+
+// 2^order sayfalık, kendi boyutuna hizalı block; başarısızsa 0
+uint32_t pmm_alloc(uint32_t order) {
+    uint32_t addr = alloc_block(order);
+    if (addr) clear_zero_flags(addr, 1u << order);
+    return addr;
+}
+
+// Tam npages sayfalık bitişik alan. Önce tek buddy block'u dener ve kuyruğu
+// geri verir; olmazsa birbirine bitişik boş block'lardan bir koşu arar.
+static uint32_t alloc_run(uint32_t npages) {
+    if (!npages) return 0;
+    uint32_t order = pmm_order_for(npages << PAGE_SHIFT);
+    if ((1u << order) >= npages) {
+        uint32_t addr = alloc_block(order);
+        if (addr) {
+            if ((1u << order) > npages) {
+                uint32_t pfn = addr >> PAGE_SHIFT;
+                release_range(pfn + npages, pfn + (1u << order));
+            }
+            return addr;
+        }
+    }
+
+    // Yavaş yol: boş block başlarını sırayla yürü
+    uint32_t run_start = 0, run_len = 0;
+    uint32_t pfn = 0;
+    while (pfn < max_pfn) {
+        if (pages[pfn].flags & PG_FREE) {
+            if (run_len == 0) run_start = pfn;
+            run_len += 1u << pages[pfn].order;
+            pfn += 1u << pages[pfn].order;
+            if (run_len >= npages) break;
+        } else {
+            run_len = 0;
+            pfn++;
+        }
+    }
+    if (run_len < npages) return 0;
+
+    // Koşudaki block'ları listelerden çıkar, fazlasını geri ver
+    pfn = run_start;
+    while (pfn < run_start + run_len) {
+        uint32_t k = pages[pfn].order;
+        list_remove(k, &pages[pfn]);
+        pages[pfn].flags &= ~PG_FREE;
+        pfn += 1u << k;
+    }
+    free_pages -= run_len;
+    if (run_len > npages) release_range(run_start + npages, run_start + run_len);
+    return run_start << PAGE_SHIFT;
+}
+
+uint32_t pmm_alloc_pages(uint32_t npages) {
+    uint32_t addr = alloc_run(npages);
+    if (addr) clear_zero_flags(addr, npages);
+    return addr;
+}
+
+// Sıfırlanmış sayfalar: boştayken zaten sıfırlanmış olanlar (PG_ZERO) atlanır
+uint32_t pmm_alloc_pages_zeroed(uint32_t npages) {
+    uint32_t addr = alloc_run(npages);
+    if (!addr) return 0;
+
+    uint32_t pfn = addr >> PAGE_SHIFT;
+    for (uint32_t i = 0; i < npages; i++) {
+        if (!(pages[pfn + i].flags & PG_ZERO)) zero_page(addr + i * PAGE_SIZE);
+        pages[pfn + i].flags &= ~PG_ZERO;
+    }
+    return addr;
+}
+
+void pmm_free(uint32_t addr, uint32_t order) {
+    if (!addr || order > PMM_MAX_ORDER) return;
+    uint32_t pfn = addr >> PAGE_SHIFT;
+    if (pfn >= max_pfn || (pages[pfn].flags & (PG_FREE | PG_RESERVED))) return;
+
+    for (uint32_t i = 0; i < (1u << order); i++) {
+        pages[pfn + i].flags = 0;
+    }
+    free_block(pfn, order);
+    zero_scan_done = 0;
+}
+
+// Order'a bağlı olmayan sayfa aralığı (ör. pmm_alloc'tan artan kuyruk).
+// Boşaltılan sayfa sayısını döner; aralıkta boş ya da rezerve sayfa varsa 0.
+uint32_t pmm_free_pages(uint32_t addr, uint32_t npages) {
+    uint32_t pfn = addr >> PAGE_SHIFT;
+    if (!addr || !npages || pfn + npages > max_pfn || pfn + npages < pfn) return 0;
+
+    for (uint32_t i = 0; i < npages; i++) {
+        if (pages[pfn + i].flags & (PG_FREE | PG_RESERVED)) return 0;
+    }
+    for (uint32_t i = 0; i < npages; i++) {
+        pages[pfn + i].flags = 0;
+    }
+    release_range(pfn, pfn + npages);
+    zero_scan_done = 0;
+    return npages;
+}
+
+// bytes'ı karşılayan en küçük order
+uint32_t pmm_order_for(uint32_t bytes) {
+    uint32_t order = 0;
+    while (order < PMM_MAX_ORDER && ((uint32_t)PAGE_SIZE << order) < bytes) order++;
+    return order;
+}
+
+struct page* pmm_page(uint32_t addr) {
+    uint32_t pfn = addr >> PAGE_SHIFT;
+    if (!pages || pfn >= max_pfn) return 0;
+    return &pages[pfn];
+}
+
+uint32_t pmm_page_addr(struct page* pg) {
+    return (uint32_t)(pg - pages) << PAGE_SHIFT;
+}
+
+// Tek sayfalık frame'i bir address space daha paylaşıyor (fork)
+void pmm_page_get(uint32_t addr) {
+    struct page* pg = pmm_page(addr);
+    if (pg) pg->refs++;
+}
+
+// Paylaşan kalmadıysa frame'i boşalt
+void pmm_page_put(uint32_t addr) {
+    struct page* pg = pmm_page(addr);
+    if (pg && pg->refs) {
+        pg->refs--;
+        return;
+    }
+    pmm_free_pages(addr, 1);
+}
+
+void pmm_get_stats(struct pmm_stats* stats) {
+    stats->total_pages = total_pages;
+    stats->free_pages = free_pages;
+    stats->largest_order = -1;
+    for (int k = PMM_MAX_ORDER; k >= 0; k--) {
+        if (free_lists[k]) {
+            stats->largest_order = k;
+            break;
+        }
+    }
+}
+
+// Boşta çağrılır: en fazla max_pages boş sayfayı sıfırlayıp PG_ZERO ile
+// işaretler, böylece pmm_alloc_pages_zeroed onları tekrar sıfırlamaz.
+// Bütün dizi iş bulunmadan taranınca bir sonraki free'ye kadar durur.
+uint32_t pmm_zero_idle(uint32_t max_pages) {
+    if (zero_scan_done || !pages) return 0;
+
+    uint32_t done = 0, scanned = 0;
+    while (done < max_pages && scanned < max_pfn) {
+        if (zero_cursor >= max_pfn) zero_cursor = 0;
+        struct page* p = &pages[zero_cursor];
+        if (!(p->flags & PG_FREE)) {
+            zero_cursor++;
+            scanned++;
+            continue;
+        }
+
+        uint32_t n = 1u << p->order;
+        uint32_t i = 0;
+        for (; i < n && done < max_pages; i++) {
+            if (pages[zero_cursor + i].flags & PG_ZERO) continue;
+            zero_page((zero_cursor + i) << PAGE_SHIFT);
+            pages[zero_cursor + i].flags |= PG_ZERO;
+            done++;
+        }
+        if (i < n) break; // Bütçe bitti, bu block'tan devam edilecek
+        zero_cursor += n;
+        scanned += n;
+    }
+
+    if (done == 0) zero_scan_done = 1;
+    return done;
+}
@@ -0,0 +1,51 @@
+#ifndef PMM_H
+#define PMM_H
+
+// Kendi typedef'lerimiz
+typedef unsigned char uint8_t;
+typedef unsigned short uint16_t;
+typedef unsigned int uint32_t;
+
+// Fiziksel sayfa boyutu ve buddy allocator sınırları
+#define PAGE_SIZE       4096
+#define PAGE_SHIFT      12
+#define PMM_MAX_ORDER   15      // 2^15 sayfa = 128MB en büyük block
+#define PMM_PHYS_LIMIT  0x30000000  // Paging'in kernel'e eşlediği RAM penceresi (768MB)
+
+// Sayfa bayrakları
+#define PG_RESERVED     0x01    // Kullanılamaz (BIOS, kernel image, multiboot, ...)
+#define PG_FREE         0x02    // Boş buddy block'unun ilk sayfası
+#define PG_SLAB         0x04    // kmalloc slab'ına ait
+#define PG_ZERO         0x08    // İçeriği sıfır olduğu biliniyor (sadece boş sayfalarda anlamlı)
+
+// Her fiziksel sayfa için bir kayıt
+struct page {
+    struct page* next;      // Buddy free listesi (PG_FREE iken) ya da sahibinin listesi
+    struct page* prev;
+    uint8_t flags;
+    uint8_t order;          // PG_FREE block'unun order'ı
+    uint16_t refs;          // Sayfayı COW ile paylaşan ek address space sayısı
+};
+
+struct pmm_stats {
+    uint32_t total_pages;   // Yönetilen (usable) sayfa sayısı
+    uint32_t free_pages;
+    int largest_order;      // En büyük boş block'un order'ı, yoksa -1
+};
+
+// Physical memory manager fonksiyonları
+void pmm_init();
+uint32_t pmm_alloc(uint32_t order);
+uint32_t pmm_alloc_pages(uint32_t npages);
+uint32_t pmm_alloc_pages_zeroed(uint32_t npages);
+void pmm_free(uint32_t addr, uint32_t order);
+uint32_t pmm_free_pages(uint32_t addr, uint32_t npages);
+uint32_t pmm_order_for(uint32_t bytes);
+struct page* pmm_page(uint32_t addr);
+uint32_t pmm_page_addr(struct page* pg);
+void pmm_page_get(uint32_t addr);
+void pmm_page_put(uint32_t addr);
+void pmm_get_stats(struct pmm_stats* stats);
+uint32_t pmm_zero_idle(uint32_t max_pages);
+
+#endif
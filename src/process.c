@@ -1,11 +1,13 @@
 #include "process.h"
 #include "memory.h"
-
-#define MAX_PROCESSES 10
-#define PROCESS_STACK_SIZE 4096
+#include "paging.h"
+#include "vm.h"
+#include "vdso.h"
+#include "timer.h"
+#include "z_utils.h"
 
 // Basit strcpy fonksiyonu
-void strcpy(char* dest, char* src) {
+void strcpy(char* dest, const char* src) {
     while (*src) {
         *dest = *src;
         dest++;
@@ -44,35 +46,470 @@ int strlen(const char* str) {
 // Process list
 struct process* process_list = 0;
 struct process* current_process = 0;
-uint32_t next_pid = 1;
+
+// --- Pid'ler: bitmap'ten ayrılır, hash'ten bulunur ---
+//
+// Pid'ler next-fit ayrılır (son verilenin bir fazlasından aranır), böylece
+// yeni biten bir process'in pid'i hemen tekrar kullanılmaz. Process
+// serbest kalınca pid'i bitmap'e geri döner. pid 0 kernel process'in.
+
+#define PID_WORDS       (PID_MAX / 32)
+#define PID_HASH_SIZE   256
+
+static uint32_t pid_bitmap[PID_WORDS];
+static uint32_t pid_last = 0;
+static struct process* pid_hash[PID_HASH_SIZE];
+
+static uint32_t pid_alloc() {
+    uint32_t start = (pid_last + 1) % PID_MAX;
+    // Son tur başlangıç word'ünün maskelenen alt bitlerine tekrar bakar
+    for (uint32_t i = 0; i <= PID_WORDS; i++) {
+        uint32_t w = (start / 32 + i) % PID_WORDS;
+        uint32_t free = ~pid_bitmap[w];
+        if (i == 0) free &= ~0u << (start % 32);
+        if (!free) continue;
+        uint32_t bit;
+        __asm__("bsf %1, %0" : "=r"(bit) : "rm"(free));
+        pid_bitmap[w] |= 1u << bit;
+        pid_last = w * 32 + bit;
+        return pid_last;
+    }
+    return 0;  // Bütün pid'ler kullanımda
+}
+
+// p'ye pid ver ve hash'e koy
+static int pid_attach(struct process* p) {
+    p->pid = pid_alloc();
+    if (!p->pid) return -1;
+    struct process** bucket = &pid_hash[p->pid % PID_HASH_SIZE];
+    p->hash_next = *bucket;
+    *bucket = p;
+    return 0;
+}
+
+// p'yi hash'ten çıkar, pid'ini bitmap'e geri ver
+static void pid_detach(struct process* p) {
+    struct process** link = &pid_hash[p->pid % PID_HASH_SIZE];
+    while (*link && *link != p) link = &(*link)->hash_next;
+    if (!*link) return;  // Hash'te değil (benchmark'ların yerel process'leri)
+    *link = p->hash_next;
+    p->hash_next = 0;
+    if (p->pid) pid_bitmap[p->pid / 32] &= ~(1u << (p->pid % 32));
+}
+
+// current_process'i değiştir; vDSO sayfasındaki pid de onunla gider
+static void set_current(struct process* p) {
+    current_process = p;
+    vdso_set_pid(p ? p->pid : 0);
+}
+
+// --- Scheduler ---
+//
+// Her process'in kendi kernel stack'i var (shell'in başlattığı program
+// shell'in stack'inin elf_load_and_run'ın altında kalan kısmını kullanır).
+// Geçiş switch_context ile stack'ten stack'e: kesilen process'in user
+// register'ları kernel stack'indeki struct regs'te kalır, iret onları geri
+// yükler. Timer sadece user'da çalışan process'i keser; kernel kodu
+// (syscall'lar interrupt'lar kapalı çalışır, shell ring 0'da) kendisi
+// bloklanana ya da process_yield çağırana kadar devam eder.
+
+extern void switch_context(uint32_t* old_esp, uint32_t new_esp);
+extern void process_fork_return();
+extern void process_thread_start();
+extern void tss_set_kernel_stack(uint32_t kss, uint32_t kesp);
+
+static struct process* kernel_process = 0;
+static struct process* dead_thread = 0;    // Stack'i bir sonraki geçişte boşaltılacak
+
+static void process_free(struct process* p);
+
+static uint32_t irq_save() {
+    uint32_t flags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(flags) :: "memory");
+    return flags;
+}
+
+static void irq_restore(uint32_t flags) {
+    if (flags & 0x200) __asm__ volatile("sti" ::: "memory");
+}
+
+// --- Kernel stack'leri ---
+//
+// KSTACK_AREA'da her slot bir guard sayfası + KSTACK_SIZE. Sayfalar pmm'den
+// tek tek gelir (bitişik olmaları gerekmez) ve bütün directory'lerde ortak
+// kernel page table'larına eşlenir. Guard sayfası hiç eşlenmez: taşan
+// stack komşusunu sessizce ezmek yerine double fault verir. Sayfalar sıfırlı
+// gelir; en derin kullanım alttan sıfır kalmış word'lerden bulunur.
+
+#define KSTACK_SLOT_SIZE    (KSTACK_SIZE + PAGE_SIZE)
+#define KSTACK_SLOTS        (KSTACK_AREA_SIZE / KSTACK_SLOT_SIZE)
+
+static uint32_t kstack_bitmap[(KSTACK_SLOTS + 31) / 32];
+
+static void kstack_unmap(uint32_t base, uint32_t size) {
+    for (uint32_t off = 0; off < size; off += PAGE_SIZE) {
+        uint32_t phys = paging_unmap(paging_kernel_directory(), base + off);
+        if (phys) pmm_free_pages(phys, 1);
+    }
+}
+
+static int kstack_alloc(struct process* p) {
+    uint32_t slot = 0;
+    while (slot < KSTACK_SLOTS && kstack_bitmap[slot / 32] == 0xFFFFFFFF) slot += 32;
+    while (slot < KSTACK_SLOTS && (kstack_bitmap[slot / 32] & (1u << (slot % 32)))) slot++;
+    if (slot >= KSTACK_SLOTS) return -1;
+
+    uint32_t base = KSTACK_AREA_BASE + slot * KSTACK_SLOT_SIZE + PAGE_SIZE;
+    for (uint32_t off = 0; off < KSTACK_SIZE; off += PAGE_SIZE) {
+        uint32_t phys = pmm_alloc_pages_zeroed(1);
+        if (!phys || paging_map(paging_kernel_directory(), base + off, phys, PTE_WRITE) < 0) {
+            if (phys) pmm_free_pages(phys, 1);
+            kstack_unmap(base, off);
+            return -1;
+        }
+    }
+    kstack_bitmap[slot / 32] |= 1u << (slot % 32);
+    p->stack = base;
+    p->stack_size = KSTACK_SIZE;
+    p->kstack_top = base + KSTACK_SIZE;
+    return 0;
+}
+
+static void kstack_free(struct process* p) {
+    uint32_t slot = (p->stack - PAGE_SIZE - KSTACK_AREA_BASE) / KSTACK_SLOT_SIZE;
+    kstack_unmap(p->stack, p->stack_size);
+    kstack_bitmap[slot / 32] &= ~(1u << (slot % 32));
+    p->stack = 0;
+}
+
+// Kernel stack'inin şimdiye kadarki en derin kullanımı (byte); kernel
+// process'i boot stack'inde, onunki bilinmiyor
+uint32_t process_stack_used(struct process* p) {
+    if (!p->stack) return 0;
+    uint32_t* w = (uint32_t*)p->stack;
+    uint32_t* top = (uint32_t*)(p->stack + p->stack_size);
+    while (w < top && !*w) w++;
+    return (uint32_t)top - (uint32_t)w;
+}
+
+// switch_context'in geri yükleyeceği çerçeve: eflags, edi, esi, ebx, ebp, dönüş adresi
+static void kstack_push_context(struct process* p, uint32_t* sp, void (*ret)()) {
+    *--sp = (uint32_t)ret;
+    *--sp = 0;              // ebp
+    *--sp = 0;              // ebx
+    *--sp = 0;              // esi
+    *--sp = 0;              // edi
+    *--sp = 0x002;          // eflags: IF kapalı, dönüş yolu açar
+    p->esp = (uint32_t)sp;
+}
+
+// --- Run queue: öncelik başına FIFO kuyruk + bitmap (O(1)) ---
+//
+// READY process'ler prio indeksli kuyruklarda durur; bitmap'te bir bit o
+// kuyruğun boş olmadığını söyler, sıradaki process bsf ile bulunur. İki
+// dizi var: slice'ını bitiren SCHED_OTHER process expired'a geçer, active
+// boşalınca diziler yer değiştirir; böylece düşük öncelikliler de sıra
+// alır. Realtime (FIFO/RR) process'ler hep active'de kalır.
+
+#define PRIO_WORDS  (PRIO_LEVELS / 32)
+
+struct prio_array {
+    uint32_t nr;
+    uint32_t bitmap[PRIO_WORDS];
+    struct process* head[PRIO_LEVELS];
+    struct process* tail[PRIO_LEVELS];
+};
+
+struct runqueue {
+    struct prio_array arrays[2];
+    struct prio_array* active;
+    struct prio_array* expired;
+};
+
+static struct runqueue runqueue;
+static int need_resched = 0;    // Daha öncelikli biri READY oldu
+
+static void rq_init(struct runqueue* rq) {
+    z_memset(rq, 0, sizeof(*rq));
+    rq->active = &rq->arrays[0];
+    rq->expired = &rq->arrays[1];
+}
+
+static void rq_enqueue(struct prio_array* a, struct process* p) {
+    uint32_t prio = p->prio;
+    p->rq_array = a;
+    p->rq_next = 0;
+    p->rq_prev = a->tail[prio];
+    if (a->tail[prio]) a->tail[prio]->rq_next = p;
+    else a->head[prio] = p;
+    a->tail[prio] = p;
+    a->bitmap[prio / 32] |= 1u << (prio % 32);
+    a->nr++;
+}
+
+static void rq_dequeue(struct process* p) {
+    struct prio_array* a = p->rq_array;
+    if (!a) return;
+    uint32_t prio = p->prio;
+    if (p->rq_prev) p->rq_prev->rq_next = p->rq_next;
+    else a->head[prio] = p->rq_next;
+    if (p->rq_next) p->rq_next->rq_prev = p->rq_prev;
+    else a->tail[prio] = p->rq_prev;
+    if (!a->head[prio]) a->bitmap[prio / 32] &= ~(1u << (prio % 32));
+    a->nr--;
+    p->rq_array = 0;
+    p->rq_next = p->rq_prev = 0;
+}
+
+// En öncelikli READY process (kuyruktan çıkarılmaz); yoksa 0
+static struct process* rq_pick(struct runqueue* rq) {
+    if (!rq->active->nr) {
+        struct prio_array* t = rq->active;
+        rq->active = rq->expired;
+        rq->expired = t;
+    }
+    struct prio_array* a = rq->active;
+    for (uint32_t w = 0; w < PRIO_WORDS; w++) {
+        if (a->bitmap[w]) {
+            uint32_t bit;
+            __asm__("bsf %1, %0" : "=r"(bit) : "rm"(a->bitmap[w]));
+            return a->head[w * 32 + bit];
+        }
+    }
+    return 0;
+}
+
+// Realtime: rt_priority 99 -> 0, 1 -> PRIO_RT_LEVELS-1; normal: nice -20..19
+static uint32_t process_prio(struct process* p) {
+    if (p->policy == SCHED_FIFO || p->policy == SCHED_RR) {
+        return (RT_PRIO_MAX - p->rt_priority) * PRIO_RT_LEVELS / RT_PRIO_MAX;
+    }
+    return PRIO_RT_LEVELS + (uint32_t)(p->nice - NICE_MIN);
+}
+
+// nice -20: 2x, nice 0: PROCESS_TIME_SLICE, nice 19: 1 tick
+static uint32_t process_slice(struct process* p) {
+    if (p->policy != SCHED_OTHER) return PROCESS_TIME_SLICE;
+    uint32_t ticks = (uint32_t)(NICE_MAX + 1 - p->nice) * PROCESS_TIME_SLICE / (NICE_MAX + 1);
+    return ticks ? ticks : 1;
+}
+
+// p'yi READY yap ve active kuyruğa koy
+static void process_set_ready(struct process* p) {
+    p->state = PROCESS_READY;
+    if (!p->slice) p->slice = process_slice(p);
+    rq_enqueue(runqueue.active, p);
+    if (current_process && p->prio < current_process->prio) need_resched = 1;
+}
+
+// Sıradaki en öncelikli READY process'e geç. Çağıran RUNNING ise kuyruğa
+// geri döner (slice'ı bittiyse expired'a); BLOCKED ya da TERMINATED ise
+// başka biri çalışabilir olana kadar timer_idle ile beklenir.
+void process_schedule() {
+    uint32_t flags = irq_save();
+    struct process* prev = current_process;
+    if (!prev) {
+        irq_restore(flags);
+        return;
+    }
+    need_resched = 0;
+
+    if (prev->state == PROCESS_RUNNING) {
+        prev->state = PROCESS_READY;
+        if (!prev->slice) {
+            prev->slice = process_slice(prev);
+            rq_enqueue(prev->policy == SCHED_OTHER ? runqueue.expired : runqueue.active, prev);
+        } else {
+            rq_enqueue(runqueue.active, prev);
+        }
+    }
+
+    struct process* next = rq_pick(&runqueue);
+    while (!next) {
+        timer_idle();
+        next = rq_pick(&runqueue);
+    }
+    rq_dequeue(next);
+    next->state = PROCESS_RUNNING;
+    if (next == prev) {
+        irq_restore(flags);
+        return;
+    }
+
+    if (next->mm && next->mm != mm_current()) mm_switch(next->mm);
+    if (next->kstack_top) tss_set_kernel_stack(0x10, next->kstack_top);
+
+    // x87 durumu process'e ait; fnsave FPU'yu sıfırlar
+    __asm__ volatile("fnsave (%0)" : : "r"(prev->fpu) : "memory");
+    prev->fpu_saved = 1;
+    if (next->fpu_saved) {
+        __asm__ volatile("frstor (%0)" : : "r"(next->fpu) : "memory");
+    } else {
+        __asm__ volatile("fninit");
+    }
+
+    set_current(next);
+    switch_context(&prev->esp, next->esp);
+
+    // Buraya prev tekrar seçildiğinde dönülür
+    if (dead_thread && dead_thread != current_process) {
+        process_free(dead_thread);
+        dead_thread = 0;
+    }
+    irq_restore(flags);
+}
+
+void process_yield() {
+    process_schedule();
+}
+
+// Ring 0 kesilmez: uzun süren kernel işi (worker thread'ler) bunu arada
+// çağırır, daha öncelikli biri uyandıysa (tuşa basıldı, uyku bitti) sıra ona geçer
+void process_cond_resched() {
+    if (need_resched) process_yield();
+}
+
+static void wait_queue_remove(struct process* p) {
+    struct process** link = &p->wq->head;
+    while (*link && *link != p) link = &(*link)->wq_next;
+    if (*link) *link = p->wq_next;
+    p->wq = 0;
+    p->wq_next = 0;
+}
+
+// Çalışan process'i wq'da uyut. Uyandırılınca ya da başka bir sebeple
+// çalışabilir olunca döner; çağıran beklediği koşula tekrar bakar. Koşula
+// interrupt'lar kapalıyken bakılmalı, yoksa arada gelen uyandırma kaçar.
+void process_wait_event(struct wait_queue* wq) {
+    uint32_t flags = irq_save();
+    struct process* p = current_process;
+    if (!p) {
+        timer_idle();   // Scheduler kurulmadan önce: bir interrupt'a kadar bekle
+        irq_restore(flags);
+        return;
+    }
+    p->wq = wq;
+    p->wq_next = wq->head;
+    wq->head = p;
+    p->state = PROCESS_BLOCKED;
+    process_schedule();
+    if (p->wq) wait_queue_remove(p);
+    irq_restore(flags);
+}
+
+// wq'da bekleyen herkesi uyandır; interrupt'tan da çağrılabilir
+void process_wake_queue(struct wait_queue* wq) {
+    uint32_t flags = irq_save();
+    struct process* p = wq->head;
+    wq->head = 0;
+    while (p) {
+        struct process* next = p->wq_next;
+        p->wq = 0;
+        p->wq_next = 0;
+        process_wake(p);
+        p = next;
+    }
+    irq_restore(flags);
+}
+
+// Timer interrupt'ı (IRQ0, EOI gönderildikten sonra): user'da slice'ını
+// bitiren ya da daha öncelikli biri uyanan process sırayı bırakır.
+// SCHED_FIFO'nun slice'ı yok.
+void process_tick(struct regs* r) {
+    struct process* p = current_process;
+    if (!p) return;
+    if (process_check_signal(r)) return;
+    if (p->slice && p->policy != SCHED_FIFO) p->slice--;
+    if ((!p->slice || need_resched) && (r->cs & 3) == 3) process_schedule();
+}
+
+// Bloklanmış process'i çalışabilir yap; uyanan beklediği koşula tekrar bakar
+void process_wake(struct process* p) {
+    if (p && p->state == PROCESS_BLOCKED) process_set_ready(p);
+}
+
+struct process* process_find(uint32_t pid) {
+    for (struct process* p = pid_hash[pid % PID_HASH_SIZE]; p; p = p->hash_next) {
+        if (p->pid == pid) return p;
+    }
+    return 0;
+}
+
+// Öncelik değişince READY process yeni kuyruğuna taşınır
+static void process_requeue(struct process* p) {
+    uint32_t flags = irq_save();
+    int queued = p->rq_array != 0;
+    if (queued) rq_dequeue(p);
+    p->prio = process_prio(p);
+    if (queued) rq_enqueue(runqueue.active, p);
+    if (current_process && p != current_process && queued && p->prio < current_process->prio) need_resched = 1;
+    if (p == current_process) need_resched = 1;
+    irq_restore(flags);
+}
+
+int process_set_nice(struct process* p, int nice) {
+    if (nice < NICE_MIN) nice = NICE_MIN;
+    if (nice > NICE_MAX) nice = NICE_MAX;
+    p->nice = nice;
+    process_requeue(p);
+    return 0;
+}
+
+// SCHED_OTHER'da rt_priority 0, FIFO/RR'de 1..99 olmalı
+int process_set_scheduler(struct process* p, uint32_t policy, uint32_t rt_priority) {
+    if (policy == SCHED_OTHER) {
+        if (rt_priority) return -22;  // EINVAL
+    } else if (policy == SCHED_FIFO || policy == SCHED_RR) {
+        if (rt_priority < 1 || rt_priority > RT_PRIO_MAX) return -22;
+    } else {
+        return -22;
+    }
+    p->policy = policy;
+    p->rt_priority = rt_priority;
+    p->slice = process_slice(p);
+    process_requeue(p);
+    return 0;
+}
 
 void process_init() {
     // İlk process'i oluştur (kernel process)
-    current_process = (struct process*)kmalloc(sizeof(struct process));
+    current_process = (struct process*)kcalloc(1, sizeof(struct process));
     current_process->pid = 0;
     current_process->state = PROCESS_RUNNING;
     current_process->stack = 0;
     current_process->stack_size = 0;
     strcpy(current_process->name, "kernel");
     current_process->next = 0;
+    current_process->prio = process_prio(current_process);
     process_list = current_process;
+    pid_bitmap[0] |= 1;     // pid 0 kernel'in
+    pid_hash[0] = current_process;
+    rq_init(&runqueue);
 }
 
-uint32_t process_create(char* name, void* entry_point) {
-    if (next_pid >= MAX_PROCESSES) {
-        return 0; // Process limit reached
-    }
-    
+// Kernel thread: kendi stack'inde entry(arg)'ı çağırır, dönünce biter
+uint32_t process_create(char* name, void (*entry)(void* arg), void* arg) {
     // Yeni process oluştur
-    struct process* new_process = (struct process*)kmalloc(sizeof(struct process));
-    new_process->pid = next_pid++;
-    new_process->state = PROCESS_READY;
-    new_process->stack = (uint32_t)kmalloc(PROCESS_STACK_SIZE);
-    new_process->stack_size = PROCESS_STACK_SIZE;
-    new_process->eip = (uint32_t)entry_point;
-    new_process->esp = new_process->stack + PROCESS_STACK_SIZE - 16;
-    new_process->ebp = new_process->esp;
+    struct process* new_process = (struct process*)kcalloc(1, sizeof(struct process));
+    if (!new_process) return 0;
+    if (kstack_alloc(new_process) < 0) {
+        kfree(new_process);
+        return 0;
+    }
+    if (pid_attach(new_process) < 0) {
+        kstack_free(new_process);
+        kfree(new_process);
+        return 0;  // Pid kalmadı
+    }
     strcpy(new_process->name, name);
+
+    // process_thread_start: entry(arg) çağrılır, sonra process_thread_exit
+    uint32_t* sp = (uint32_t*)new_process->kstack_top;
+    *--sp = (uint32_t)arg;              // entry'nin argümanı
+    *--sp = (uint32_t)entry;
+    kstack_push_context(new_process, sp, process_thread_start);
+    new_process->prio = process_prio(new_process);
+    process_set_ready(new_process);
     
     // Process list'e ekle
     new_process->next = process_list;
@@ -81,48 +518,503 @@ uint32_t process_create(char* name, void* entry_point) {
     return new_process->pid;
 }
 
-void process_schedule() {
-    if (!current_process || !process_list) {
-        return;
+// Kernel thread'in entry'si döndü: stack'i bir sonraki geçişte boşaltılır
+void process_thread_exit() {
+    irq_save();
+    struct process* p = current_process;
+    p->state = PROCESS_TERMINATED;
+    if (dead_thread) process_free(dead_thread);
+    dead_thread = p;
+    process_schedule();
+}
+
+// Kernel thread'i bitir. Çalışan thread kendini bitiriyorsa struct'ı ve
+// stack'i bir sonraki geçişte boşaltılır, yoksa hemen.
+void process_exit(uint32_t pid) {
+    struct process* p = process_find(pid);
+    if (!p || p == kernel_process || !p->pid || p->mm) return;   // User process'ler exit/kill ile biter
+    if (p == current_process) process_thread_exit();    // Dönmez
+    p->state = PROCESS_TERMINATED;
+    process_free(p);
+}
+
+// Process listesinin özeti: en fazla max tane, yazılan sayı döner
+int process_get_stats(struct process_stats* stats, int max) {
+    int n = 0;
+    for (struct process* p = process_list; p && n < max; p = p->next, n++) {
+        stats[n].pid = p->pid;
+        stats[n].state = p->state;
+        strcpy(stats[n].name, p->name);
+        stats[n].kstack_size = p->stack_size;
+        stats[n].kstack_used = process_stack_used(p);
+        stats[n].ustack_size = p->mm ? mm_stack_size(p->mm) : 0;
     }
-    
-    // Round-robin scheduling
-    struct process* next = current_process->next;
-    if (!next) {
-        next = process_list;
+    return n;
+}
+
+// --- User programları ve fork ---
+//
+// Shell'in başlattığı program ve onun fork'ladıkları scheduler'da beraber
+// çalışır. fork'ta parent hemen child'ın pid'iyle döner; vfork'ta child
+// çıkana kadar bekler. Çıkan child zombie olur, waitpid toplar; program
+// bitince kalan bütün process'ler silinir.
+
+static void process_unlink(struct process* p) {
+    struct process** link = &process_list;
+    while (*link && *link != p) link = &(*link)->next;
+    if (*link) *link = p->next;
+}
+
+// Process'i listeden çıkar, address space'ini ve kernel stack'ini bırak
+static void process_free(struct process* p) {
+    rq_dequeue(p);
+    if (p->wq) wait_queue_remove(p);
+    process_unlink(p);
+    pid_detach(p);
+    timer_del(&p->timer);
+    timer_del(&p->alarm);
+    if (p->mm) mm_destroy(p->mm);
+    if (p->stack) kstack_free(p);
+    if (dead_thread == p) dead_thread = 0;
+    kfree(p);
+}
+
+// Shell'in çalıştırdığı program için process; mm'in sahibi artık o
+struct process* process_start_program(char* name, struct mm* mm) {
+    struct process* p = (struct process*)kcalloc(1, sizeof(struct process));
+    if (!p) return 0;
+    if (pid_attach(p) < 0) {
+        kfree(p);
+        return 0;
     }
-    
-    // Ready state'deki process'i bul
-    while (next != current_process) {
-        if (next->state == PROCESS_READY) {
-            // Context switch
-            current_process->state = PROCESS_READY;
-            next->state = PROCESS_RUNNING;
-            current_process = next;
-            return;
+    p->state = PROCESS_RUNNING;
+    p->prio = process_prio(p);
+    p->slice = process_slice(p);
+    p->mm = mm;
+    strcpy(p->name, name);
+    p->next = process_list;
+    process_list = p;
+
+    kernel_process = current_process;
+    if (kernel_process) kernel_process->state = PROCESS_BLOCKED;
+    set_current(p);
+    return p;
+}
+
+// Program exit ya da fault ile bitti: ona ait bütün process'ler (zombie'ler
+// ve hâlâ çalışan child'lar) address space'leriyle birlikte silinir
+void process_end_program() {
+    mm_switch(0);
+    struct process* p = process_list;
+    while (p) {
+        struct process* next = p->next;
+        if (p != kernel_process && (p->mm || p->state == PROCESS_TERMINATED)) process_free(p);
+        p = next;
+    }
+    set_current(kernel_process);
+    if (current_process) current_process->state = PROCESS_RUNNING;
+}
+
+// Child process oluştur: address space'i COW ile kopyalanır ya da
+// FORK_SHARE_VM ile paylaşılır, kendi kernel stack'i ayrılır. Child
+// listeye BLOCKED girer; çalışacağı frame'i çağıran kurar.
+struct process* process_fork(struct process* parent, uint32_t flags) {
+    if (!parent || !parent->mm) return 0;
+    struct process* child = (struct process*)kcalloc(1, sizeof(struct process));
+    if (!child) return 0;
+    if (kstack_alloc(child) < 0) {
+        kfree(child);
+        return 0;
+    }
+    if (pid_attach(child) < 0) {
+        kstack_free(child);
+        kfree(child);
+        return 0;
+    }
+
+    if (flags & FORK_SHARE_VM) {
+        child->mm = parent->mm;
+        child->mm->users++;
+    } else {
+        child->mm = mm_fork(parent->mm);
+        if (!child->mm) {
+            pid_detach(child);
+            kstack_free(child);
+            kfree(child);
+            return 0;
         }
-        next = next->next;
-        if (!next) {
-            next = process_list;
+    }
+    child->state = PROCESS_BLOCKED;
+    child->parent = parent;
+    child->policy = parent->policy;
+    child->nice = parent->nice;
+    child->rt_priority = parent->rt_priority;
+    child->prio = parent->prio;
+    strcpy(child->name, parent->name);
+    child->next = process_list;
+    process_list = child;
+    return child;
+}
+
+// fork/vfork/clone syscall'ı: r çağıranın frame'i. Child bu frame'in
+// kopyasıyla (eax = 0) process_fork_return'den user'a döner; parent child'ın
+// pid'ini alır, FORK_VFORK'ta child çıkana kadar bekler.
+int process_sys_fork(struct regs* r, uint32_t flags, uint32_t child_stack) {
+    struct process* parent = current_process;
+    if (!parent || !parent->mm) return -38;  // ENOSYS: kernel process fork'lanamaz
+
+    struct process* child = process_fork(parent, flags);
+    if (!child) return -12;  // ENOMEM
+
+    struct regs* frame = (struct regs*)(child->kstack_top - sizeof(struct regs));
+    *frame = *r;
+    frame->eax = 0;
+    if (child_stack) frame->useresp = child_stack;
+    kstack_push_context(child, (uint32_t*)frame, process_fork_return);
+
+    // Child parent'ın x87 durumuyla başlar (fnsave FPU'yu sıfırladığı için geri yüklenir)
+    __asm__ volatile("fnsave (%0); frstor (%0)" : : "r"(child->fpu) : "memory");
+    child->fpu_saved = 1;
+
+    process_set_ready(child);
+    int pid = (int)child->pid;
+    if (flags & FORK_VFORK) {
+        while (child->state != PROCESS_TERMINATED) {
+            parent->state = PROCESS_BLOCKED;
+            process_schedule();
         }
     }
+    return pid;
 }
 
-void process_yield() {
+// p zombie olur: address space'i bırakılır, child'ları parent'ına geçer,
+// bekleyen parent uyanır. Struct'ı ve kernel stack'i waitpid toplayınca gider.
+static void process_zombie(struct process* p, int status) {
+    struct mm* mm = p->mm;
+    rq_dequeue(p);
+    timer_del(&p->timer);
+    timer_del(&p->alarm);
+    p->mm = 0;
+    p->state = PROCESS_TERMINATED;
+    p->exit_code = status;
+    if (mm) mm_destroy(mm);
+
+    for (struct process* q = process_list; q; q = q->next) {
+        if (q->parent == p) q->parent = p->parent;
+    }
+    process_wake(p->parent);
+}
+
+// Fork'lanmış process'in exit'i: zombie olur ve bir daha dönülmez. Shell'in
+// başlattığı program (parent'ı yok) için 0 döner, program biter.
+int process_exit_child(int code) {
+    struct process* p = current_process;
+    if (!p || !p->parent) return 0;
+
+    irq_save();
+    process_zombie(p, (code & 0xFF) << 8);
     process_schedule();
+    return 1;  // Dönülmez
 }
 
-void process_exit(uint32_t pid) {
-    struct process* p = process_list;
-    while (p) {
-        if (p->pid == pid) {
-            p->state = PROCESS_TERMINATED;
-            // Stack'i free et
-            if (p->stack) {
-                kfree((void*)p->stack);
+// kill: sinyal teslimi yok. 0 sadece process'in varlığını sorar; diğer
+// sinyaller fork'lanmış process'i o sinyalle ölmüş gibi zombie yapar,
+// shell'in programını user'a dönerken bitirir.
+int process_kill(int pid, int sig) {
+    if (sig < 0 || sig > 64) return -22;   // EINVAL
+    struct process* p = pid > 0 ? process_find((uint32_t)pid) : 0;
+    if (!p || p->state == PROCESS_TERMINATED) return -3;   // ESRCH
+    if (!p->mm) return -1;                  // EPERM: kernel thread
+    if (!sig) return 0;
+
+    uint32_t flags = irq_save();
+    if (!p->parent) {
+        // Shell'in programı user'a dönerken biter
+        p->signal = sig;
+        process_wake(p);
+        irq_restore(flags);
+        return 0;
+    }
+    process_zombie(p, sig);
+    if (p == current_process) process_schedule();  // Dönmez
+    irq_restore(flags);
+    return 0;
+}
+
+// waitpid: çıkmış child'ı topla. Hepsi çalışıyorsa (WNOHANG yoksa) biri
+// çıkana kadar bloklanır; hiç child yoksa -ECHILD. pid verildiyse hash'ten
+// bulunur, listeyi sadece "herhangi bir child" beklemesi gezer.
+int process_wait(int pid, int* status, int options) {
+    struct process* self = current_process;
+    while (1) {
+        int children = 0;
+        struct process* zombie = 0;
+        if (pid > 0) {
+            struct process* p = process_find((uint32_t)pid);
+            if (p && p->parent == self) {
+                children = 1;
+                if (p->state == PROCESS_TERMINATED) zombie = p;
             }
-            break;
+        } else {
+            for (struct process* p = process_list; p; p = p->next) {
+                if (p->parent != self) continue;
+                children++;
+                if (p->state == PROCESS_TERMINATED) {
+                    zombie = p;
+                    break;
+                }
+            }
+        }
+        if (zombie) {
+            int child_pid = (int)zombie->pid;
+            if (status) *status = zombie->exit_code;
+            process_free(zombie);
+            return child_pid;
         }
-        p = p->next;
+        if (!children) return -10;  // ECHILD
+        if (options & WNOHANG) return 0;
+        if (self->signal) return -4;  // EINTR
+        self->state = PROCESS_BLOCKED;
+        process_schedule();
     }
-} 
\ No newline at end of file
+}
+
+// --- Uyku, alarm ve sinyaller ---
+//
+// Uyuyan process BLOCKED olur, kendi timer'ı süresi dolunca onu uyandırır;
+// CPU bu arada başka process'e ya da timer_idle'a geçer. Sinyal teslimi
+// yok: bekleyen sinyal (kill, SIGALRM) process user'a dönerken varsayılan
+// eylemiyle onu sonlandırır, uyku ve beklemeler sinyalle erken biter.
+
+static void process_sleep_timeout(void* arg) {
+    process_wake((struct process*)arg);
+}
+
+// Scheduler kurulmadan önce (boot'un başı) uyuyan kernel için
+static void boot_sleep_timeout(void* arg) {
+    *(volatile int*)arg = 1;
+}
+
+// Çalışan process'i ticks kadar uyut. Sinyal gelirse erken döner, kalan
+// tick sayısını verir.
+uint32_t process_sleep(uint32_t ticks) {
+    if (!ticks) return 0;
+    uint32_t flags = irq_save();
+    uint32_t deadline = timer_ticks() + ticks;
+    struct process* p = current_process;
+    if (!p) {
+        volatile int done = 0;
+        struct ktimer t;
+        timer_setup(&t, boot_sleep_timeout, (void*)&done);
+        timer_add(&t, deadline);
+        while (!done) timer_idle();
+        irq_restore(flags);
+        return 0;
+    }
+
+    timer_setup(&p->timer, process_sleep_timeout, p);
+    timer_add(&p->timer, deadline);
+    while (p->timer.pprev && !p->signal) {
+        p->state = PROCESS_BLOCKED;
+        process_schedule();
+    }
+    timer_del(&p->timer);
+    int left = (int)(deadline - timer_ticks());
+    irq_restore(flags);
+    return left > 0 ? (uint32_t)left : 0;
+}
+
+void process_msleep(uint32_t ms) {
+    process_sleep(TIMER_MS_TO_TICKS(ms));
+}
+
+// pause: sinyal gelene kadar uyu
+int process_pause() {
+    struct process* p = current_process;
+    if (!p) return -4;
+    uint32_t flags = irq_save();
+    while (!p->signal) {
+        p->state = PROCESS_BLOCKED;
+        process_schedule();
+    }
+    irq_restore(flags);
+    return -4;  // EINTR
+}
+
+static void process_alarm_timeout(void* arg) {
+    struct process* p = (struct process*)arg;
+    if (!p->signal) p->signal = SIGALRM;
+    if (p->alarm_interval) timer_add(&p->alarm, p->alarm.expires + p->alarm_interval);
+    process_wake(p);
+}
+
+// Alarmın kalan tick'i (kurulu değilse 0) ve interval'i
+uint32_t process_get_alarm(struct process* p, uint32_t* interval) {
+    if (interval) *interval = p->alarm_interval;
+    if (!p->alarm.pprev) return 0;
+    int left = (int)(p->alarm.expires - timer_ticks());
+    return left > 0 ? (uint32_t)left : 1;
+}
+
+// ITIMER_REAL: value tick sonra SIGALRM, sonra her interval tick'te bir
+// (value 0 ise alarm iptal). Önceki alarmın kalan süresini döner.
+uint32_t process_set_alarm(struct process* p, uint32_t value, uint32_t interval, uint32_t* old_interval) {
+    uint32_t flags = irq_save();
+    uint32_t left = process_get_alarm(p, old_interval);
+    timer_del(&p->alarm);
+    timer_setup(&p->alarm, process_alarm_timeout, p);
+    p->alarm_interval = interval;
+    if (value) timer_add(&p->alarm, timer_ticks() + value);
+    irq_restore(flags);
+    return left;
+}
+
+// Bekleyen sinyal varsa ve process user'a dönüyorsa (syscall dönüşü, timer
+// tick'i) onu sonlandır: fork'lanmış process zombie olur, shell'in
+// programı biter. Program bitirildiyse 1 döner.
+int process_check_signal(struct regs* r) {
+    struct process* p = current_process;
+    if (!p || !p->signal || (r->cs & 3) != 3) return 0;
+    int sig = p->signal;
+    p->signal = 0;
+    if (p->parent) {
+        irq_save();
+        process_zombie(p, sig);
+        process_schedule();     // Dönülmez
+    }
+    z_printf("\n[Program terminated by signal %d]\n", sig);
+    program_exit_frame(r);
+    return 1;
+}
+
+// --- Fork benchmark: program boyutunda bir address space'i N kez fork'la ---
+
+#define BENCH_HEAP      0x00400000
+#define BENCH_COW_PAGES 64
+
+// cycles'ı "X.Y" mikrosaniye olarak yaz
+static void print_us(uint32_t cycles) {
+    uint32_t mhz = timer_tsc_khz() / 1000;
+    if (!mhz) mhz = 1;
+    uint32_t tenths = cycles / mhz * 10 + (cycles % mhz) * 10 / mhz;
+    z_printf("%u.%u us", tenths / 10, tenths % 10);
+}
+
+void process_fork_benchmark(uint32_t n) {
+    if (!n) n = 100;
+
+    // Programa benzeyen parent: 1MB stack + 4MB dokunulmuş heap
+    struct process parent;
+    z_memset(&parent, 0, sizeof(parent));
+    strcpy(parent.name, "forkbench");
+    parent.mm = mm_create();
+    if (!parent.mm) return;
+    if (paging_alloc_range(parent.mm->pd, USER_STACK_TOP - USER_STACK_SIZE, USER_STACK_SIZE, PTE_USER | PTE_WRITE) < 0 ||
+        paging_alloc_range(parent.mm->pd, USER_MMAP_BASE, BENCH_HEAP, PTE_USER | PTE_WRITE) < 0) {
+        z_printf("forkbench: out of memory\n");
+        mm_destroy(parent.mm);
+        return;
+    }
+    uint32_t kb = (USER_STACK_SIZE + BENCH_HEAP) / 1024;
+    z_printf("Fork benchmark: %u children of a %u KB address space (TSC %u MHz)\n", n, kb, timer_tsc_khz() / 1000);
+
+    struct pmm_stats before, after;
+    for (int share = 0; share <= 1; share++) {
+        uint32_t total = 0, tables = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            pmm_get_stats(&before);
+            uint64_t start = rdtsc();
+            struct process* child = process_fork(&parent, share ? FORK_SHARE_VM : 0);
+            total += (uint32_t)(rdtsc() - start);
+            if (!child) {
+                z_printf("forkbench: fork failed\n");
+                mm_destroy(parent.mm);
+                return;
+            }
+            pmm_get_stats(&after);
+            tables = before.free_pages - after.free_pages - KSTACK_SIZE / PAGE_SIZE;
+            process_free(child);
+        }
+        z_printf("  %s ", share ? "vfork:" : "fork: ");
+        print_us(total / n);
+        z_printf(" per call, %u KB of page tables, 0 KB copied\n", tables * (PAGE_SIZE / 1024));
+    }
+
+    // İlk yazmanın bedeli: child'ın heap'ine kernel'den yaz, COW fault'u kopyalasın
+    struct process* child = process_fork(&parent, 0);
+    if (child) {
+        struct mm* prev = mm_current();
+        mm_switch(child->mm);
+        uint64_t start = rdtsc();
+        for (uint32_t i = 0; i < BENCH_COW_PAGES; i++) {
+            *(volatile uint8_t*)(USER_MMAP_BASE + i * PAGE_SIZE) = (uint8_t)i;
+        }
+        uint32_t cycles = (uint32_t)(rdtsc() - start);
+        uint32_t faults = child->mm->cow_faults;
+        mm_switch(prev);
+        z_printf("  COW fault: ");
+        print_us(cycles / BENCH_COW_PAGES);
+        z_printf(" per page (%u faults)\n", faults);
+        process_free(child);
+    }
+    mm_destroy(parent.mm);
+}
+
+// --- Scheduler benchmark: run queue'dan seçim maliyeti task sayısıyla büyümemeli ---
+
+#define SCHED_BENCH_PICKS   10000
+
+// Eski yol: process listesini baştan sona gezip en öncelikli READY'yi bul
+static struct process* list_pick(struct process* list) {
+    struct process* best = 0;
+    for (struct process* p = list; p; p = p->next) {
+        if (p->state == PROCESS_READY && (!best || p->prio < best->prio)) best = p;
+    }
+    return best;
+}
+
+void process_sched_benchmark(uint32_t n) {
+    if (!n) n = 1000;
+    if (n > 4096) n = 4096;
+    struct process* tasks = (struct process*)kcalloc(n, sizeof(struct process));
+    static struct runqueue rq;
+    if (!tasks) {
+        z_printf("schedbench: out of memory\n");
+        return;
+    }
+    z_printf("Scheduler benchmark: %u picks per run (TSC %u MHz)\n", SCHED_BENCH_PICKS, timer_tsc_khz() / 1000);
+
+    for (uint32_t count = 10; ; count *= 10) {
+        if (count > n) count = n;
+        rq_init(&rq);
+        for (uint32_t i = 0; i < count; i++) {
+            struct process* p = &tasks[i];
+            p->state = PROCESS_READY;
+            p->nice = (int)(i % (NICE_MAX - NICE_MIN + 1)) + NICE_MIN;
+            p->prio = process_prio(p);
+            p->slice = process_slice(p);
+            p->next = i + 1 < count ? &tasks[i + 1] : 0;
+            rq_enqueue(rq.active, p);
+        }
+
+        // process_schedule'ın yaptığı gibi: seç, çıkar, slice bitince expired'a koy
+        uint64_t start = rdtsc();
+        for (uint32_t i = 0; i < SCHED_BENCH_PICKS; i++) {
+            struct process* p = rq_pick(&rq);
+            rq_dequeue(p);
+            rq_enqueue(rq.expired, p);
+        }
+        uint32_t queue_cycles = (uint32_t)(rdtsc() - start) / SCHED_BENCH_PICKS;
+
+        start = rdtsc();
+        for (uint32_t i = 0; i < SCHED_BENCH_PICKS / 10; i++) {
+            list_pick(tasks);
+        }
+        uint32_t list_cycles = (uint32_t)(rdtsc() - start) / (SCHED_BENCH_PICKS / 10);
+
+        z_printf("  %u tasks: run queue %u cycles, list walk %u cycles per pick\n",
+                 count, queue_cycles, list_cycles);
+        if (count == n) break;
+    }
+    kfree(tasks);
+}
@@ -6,6 +6,13 @@ typedef unsigned char uint8_t;
 typedef unsigned short uint16_t;
 typedef unsigned int uint32_t;
 
+#include "interrupts.h"
+#include "timer.h"
+
+struct mm;
+struct prio_array;
+struct wait_queue;
+
 // Process states
 #define PROCESS_READY 0
 #define PROCESS_RUNNING 1
@@ -16,30 +23,121 @@ typedef unsigned int uint32_t;
 struct process {
     uint32_t pid;
     uint32_t state;
-    uint32_t esp;
-    uint32_t ebp;
-    uint32_t eip;
-    uint32_t stack;
+    uint32_t esp;               // Kernel stack'te switch_context'in bıraktığı yer
+    uint32_t stack;             // Kendi kernel stack'i (pmm sayfaları), 0 ise ödünç
     uint32_t stack_size;
+    uint32_t kstack_top;        // Ring 3'ten girişte TSS esp0
+    uint32_t slice;             // Kalan time slice (tick)
+    uint32_t policy;            // SCHED_OTHER / SCHED_FIFO / SCHED_RR
+    int nice;                   // -20..19, SCHED_OTHER için
+    uint32_t rt_priority;       // 1..99, SCHED_FIFO/RR için
+    uint32_t prio;              // Run queue indeksi, küçük olan önce çalışır
+    struct prio_array* rq_array;    // READY iken içinde durduğu kuyruk dizisi
+    struct process* rq_next;
+    struct process* rq_prev;
     char name[32];
+    struct mm* mm;              // User address space'i, kernel process'lerinde 0
+    struct process* parent;
+    int exit_code;              // waitpid status'u: exit kodu << 8 ya da sinyal
+    int fpu_saved;              // fpu geçerli mi; değilse ilk geçişte fninit
+    uint8_t fpu[108];           // fnsave alanı
+    struct ktimer timer;        // process_sleep'in uyandırıcısı
+    struct ktimer alarm;        // alarm / setitimer(ITIMER_REAL)
+    uint32_t alarm_interval;    // Tick, 0 ise alarm bir kere çalar
+    int signal;                 // Bekleyen sinyal (varsayılan eylemi: sonlandır)
+    struct wait_queue* wq;      // Üzerinde uyuduğu bekleme kuyruğu
+    struct process* wq_next;
     struct process* next;
+    struct process* hash_next;  // Pid hash zinciri
+};
+
+// Bir olayı (tuş, kuyruğa düşen iş) bekleyen process'ler
+struct wait_queue {
+    struct process* head;
+};
+
+// ps için process başına özet
+struct process_stats {
+    uint32_t pid;
+    uint32_t state;
+    char name[32];
+    uint32_t kstack_size;
+    uint32_t kstack_used;       // Kernel stack'inin en derin kullanımı
+    uint32_t ustack_size;       // User stack'inin büyüdüğü boy (en derin kullanım, sayfa granül)
 };
 
+// process_fork bayrakları
+#define FORK_SHARE_VM   0x1     // vfork / clone(CLONE_VM): address space ortak
+#define FORK_VFORK      0x2     // vfork / clone(CLONE_VFORK): parent child çıkana kadar bekler
+
+// Time slice: user'da bu kadar tick çalışan process READY olanlara yer açar
+#define PROCESS_TIME_SLICE  5
+#define KSTACK_SIZE         0x4000
+
+// Pid'ler 1..PID_MAX-1 arası, biten process'inki geri döner
+#define PID_MAX             32768
+
+// Scheduling policy'leri (Linux değerleri)
+#define SCHED_OTHER         0
+#define SCHED_FIFO          1
+#define SCHED_RR            2
+
+// Run queue: 0..PRIO_RT_LEVELS-1 realtime, geri kalanı nice -20..19
+#define PRIO_LEVELS         64
+#define PRIO_RT_LEVELS      24
+#define NICE_MIN            (-20)
+#define NICE_MAX            19
+#define RT_PRIO_MAX         99
+
+// waitpid seçenekleri
+#define WNOHANG             1
+
+// Sinyaller (teslim yok, varsayılan eylem uygulanır)
+#define SIGALRM             14
+
 // Utility fonksiyonları
-void strcpy(char* dest, char* src);
+void strcpy(char* dest, const char* src);
 int strcmp(char* s1, char* s2);
 int strncmp(char* s1, char* s2, int n);
 int strlen(const char* str);
 
 // Process management fonksiyonları
 void process_init();
-uint32_t process_create(char* name, void* entry_point);
+uint32_t process_create(char* name, void (*entry)(void* arg), void* arg);
 void process_schedule();
 void process_yield();
+void process_cond_resched();
+void process_wait_event(struct wait_queue* wq);
+void process_wake_queue(struct wait_queue* wq);
 void process_exit(uint32_t pid);
+void process_tick(struct regs* r);
+void process_wake(struct process* p);
+struct process* process_find(uint32_t pid);
+int process_set_nice(struct process* p, int nice);
+int process_set_scheduler(struct process* p, uint32_t policy, uint32_t rt_priority);
+void process_sched_benchmark(uint32_t n);
+uint32_t process_stack_used(struct process* p);
+int process_get_stats(struct process_stats* stats, int max);
+
+// User programları: shell'in başlattığı program ve fork'ladıkları
+struct process* process_start_program(char* name, struct mm* mm);
+void process_end_program();
+struct process* process_fork(struct process* parent, uint32_t flags);
+int process_sys_fork(struct regs* r, uint32_t flags, uint32_t child_stack);
+int process_exit_child(int code);
+int process_wait(int pid, int* status, int options);
+int process_kill(int pid, int sig);
+
+// Uyku, alarm ve sinyaller
+uint32_t process_sleep(uint32_t ticks);
+void process_msleep(uint32_t ms);
+int process_pause();
+uint32_t process_set_alarm(struct process* p, uint32_t value, uint32_t interval, uint32_t* old_interval);
+uint32_t process_get_alarm(struct process* p, uint32_t* interval);
+int process_check_signal(struct regs* r);
+void process_fork_benchmark(uint32_t n);
 
 // Current process
 extern struct process* current_process;
-extern uint32_t next_pid;
 
 #endif 
\ No newline at end of file
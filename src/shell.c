@@ -28,6 +28,11 @@
 #include "vga.h"
 #include "elf.h"
 #include "banner.h"
+#include "memory.h"
+#include "pagecache.h"
+#include "z_utils.h"
+#include "workqueue.h"
+#include "timer.h"
 
 // Donanım reboot fonksiyonu
 static void hw_reboot() {
@@ -92,6 +97,28 @@ void shell_init() {
 // Global banner reference for shell
 static struct banner* shell_banner = 0;
 
+// Komut başına geçici bellek: her komuttan önce arena_begin, sonra arena_reset
+static struct arena shell_arena;
+
+// name'i current_directory'ye göre mutlak path'e çevir (shell_arena'dan)
+static char* shell_resolve_path(const char* name) {
+    int dir_len = strlen(current_directory);
+    int name_len = strlen(name);
+    char* path = (char*)arena_alloc(&shell_arena, dir_len + name_len + 2);
+    if (!path) return 0;
+
+    if (name[0] == '/') {
+        strcpy(path, name);
+    } else {
+        strcpy(path, current_directory);
+        if (dir_len > 0 && current_directory[dir_len - 1] != '/') {
+            strcat(path, "/");
+        }
+        strcat(path, name);
+    }
+    return path;
+}
+
 void shell_set_banner(struct banner* banner) {
     shell_banner = banner;
 }
@@ -120,19 +147,24 @@ void shell_run() {
             shell_print_prompt();
             continue;
         }
+        arena_begin(&shell_arena);
         if (strcmp(input, "help") == 0) {
             cmd_help();
         } else if (strncmp(input, "run ", 4) == 0) {
             const char* filename = input + 4;
             // Auto-prepend / if not absolute path
-            char full_path[64];
-            if (filename[0] == '/') {
-                strcpy(full_path, filename);
+            char* full_path = (char*)arena_alloc(&shell_arena, strlen(filename) + 2);
+            if (!full_path) {
+                print("run: out of memory\n");
             } else {
-                full_path[0] = '/';
-                strcpy(full_path + 1, filename);
+                if (filename[0] == '/') {
+                    strcpy(full_path, filename);
+                } else {
+                    full_path[0] = '/';
+                    strcpy(full_path + 1, filename);
+                }
+                elf_load_and_run(full_path);
             }
-            elf_load_and_run(full_path);
         } else if (strcmp(input, "clear") == 0) {
             cmd_clear();
         } else if (strncmp(input, "ls ", 3) == 0) {
@@ -177,16 +209,38 @@ void shell_run() {
             hw_reboot();
         } else if (strcmp(input, "banner") == 0) {
             cmd_banner();
+        } else if (strcmp(input, "membench") == 0) {
+            cmd_membench();
+        } else if (strcmp(input, "meminfo") == 0) {
+            cmd_meminfo();
+        } else if (strcmp(input, "ps") == 0) {
+            cmd_ps();
+        } else if (strcmp(input, "timertest") == 0) {
+            cmd_timertest();
+        } else if (strcmp(input, "forkbench") == 0) {
+            cmd_forkbench("");
+        } else if (strncmp(input, "forkbench ", 10) == 0) {
+            cmd_forkbench(input + 10);
+        } else if (strcmp(input, "schedbench") == 0) {
+            cmd_schedbench("");
+        } else if (strncmp(input, "schedbench ", 11) == 0) {
+            cmd_schedbench(input + 11);
+        } else if (strcmp(input, "fbbench") == 0) {
+            cmd_fbbench("");
+        } else if (strncmp(input, "fbbench ", 8) == 0) {
+            cmd_fbbench(input + 8);
         } else {
             print("Unknown command: ");
             print(input);
             print("\n");
         }
+        arena_reset(&shell_arena);
         shell_print_prompt();
     }
 }
 
 void shell_execute_command(char* command) {
+    arena_begin(&shell_arena);
     if (strcmp(command, "help") == 0) {
         cmd_help();
     } else if (strcmp(command, "clear") == 0) {
@@ -225,11 +279,32 @@ void shell_execute_command(char* command) {
         cmd_mv(command + 3);
     } else if (strcmp(command, "banner") == 0) {
         cmd_banner();
+    } else if (strcmp(command, "membench") == 0) {
+        cmd_membench();
+    } else if (strcmp(command, "meminfo") == 0) {
+        cmd_meminfo();
+    } else if (strcmp(command, "ps") == 0) {
+        cmd_ps();
+    } else if (strcmp(command, "timertest") == 0) {
+        cmd_timertest();
+    } else if (strcmp(command, "forkbench") == 0) {
+        cmd_forkbench("");
+    } else if (strncmp(command, "forkbench ", 10) == 0) {
+        cmd_forkbench(command + 10);
+    } else if (strcmp(command, "schedbench") == 0) {
+        cmd_schedbench("");
+    } else if (strncmp(command, "schedbench ", 11) == 0) {
+        cmd_schedbench(command + 11);
+    } else if (strcmp(command, "fbbench") == 0) {
+        cmd_fbbench("");
+    } else if (strncmp(command, "fbbench ", 8) == 0) {
+        cmd_fbbench(command + 8);
     } else {
         print("Unknown command: ");
         print(command);
         print("\n");
     }
+    arena_reset(&shell_arena);
 }
 
 void cmd_help() {
@@ -255,7 +330,14 @@ void cmd_help() {
     print("  run <file> - Run ELF binary\n");
     print("  exit - Exit shell\n");
     print("  reboot - Reboot system\n");
-    print("  banner - Display animated banner\n");
+    print("  banner - Start/stop animated banner (runs in background)\n");
+    print("  membench - Measure kfree cost as the heap grows\n");
+    print("  meminfo - Show heap and page allocator statistics\n");
+    print("  ps - List processes with their stack usage\n");
+    print("  timertest - Check that a timer re-armed from its callback fires once per turn\n");
+    print("  forkbench [n] - Time n copy-on-write forks (default 100)\n");
+    print("  fbbench [n] - Framebuffer fill MB/s, uncached vs write-combining (default 16)\n");
+    print("  schedbench [n] - Run queue pick cost for up to n tasks (default 1000)\n");
 }
 
 void cmd_clear() {
@@ -269,22 +351,9 @@ void cmd_echo(char* args) {
 
 void cmd_ls_param(char* param) {
     // Her ls'de RAM'i diskten güncelle
-    char path[64];
-    if (param == 0 || param[0] == 0) {
-        // Parametre yoksa mevcut dizin
-        strcpy(path, current_directory);
-    } else if (param[0] == '/') {
-        // Absolute path
-        strcpy(path, param);
-    } else {
-        // Relative path
-        strcpy(path, current_directory);
-        int len = strlen(current_directory);
-        if (len > 0 && current_directory[len-1] != '/') {
-            strcat(path, "/");
-        }
-        strcat(path, param);
-    }
+    // Parametre yoksa mevcut dizin
+    char* path = (param == 0 || param[0] == 0) ? current_directory : shell_resolve_path(param);
+    if (!path) return;
     fs_list_files(path);
 }
 
@@ -294,18 +363,8 @@ void cmd_ls() {
 
 void cmd_cat(char* filename) {
     // Path oluştur
-    char full_path[64];
-    if (filename[0] == '/') {
-        // Absolute path
-        strcpy(full_path, filename);
-    } else {
-        // Relative path
-        strcpy(full_path, current_directory);
-        if (current_directory[strlen(current_directory) - 1] != '/') {
-            strcat(full_path, "/");
-        }
-        strcat(full_path, filename);
-    }
+    char* full_path = shell_resolve_path(filename);
+    if (!full_path) return;
     
     char buffer[256];
     int result = fs_read_file(full_path, buffer, 256);
@@ -340,8 +399,8 @@ void cmd_uname() {
 
 void cmd_mkdir(char* dirname) {
     // Path oluştur
-    char full_path[64];
-    if (dirname[0] == '/') { strcpy(full_path, dirname); } else { strcpy(full_path, current_directory); if (current_directory[strlen(current_directory) - 1] != '/') { strcat(full_path, "/"); } strcat(full_path, dirname); }
+    char* full_path = shell_resolve_path(dirname);
+    if (!full_path) return;
     // If already exists anywhere, report
     if (fs_any_exists(full_path)) {
         print_color("mkdir: already exists\n", VGA_COLOR_LIGHT_RED);
@@ -358,7 +417,9 @@ void cmd_cd(char* dirname) {
         if (strcmp(current_directory, "/") != 0) { char* last_slash = strrchr(current_directory, '/'); if (last_slash == current_directory) { strcpy(current_directory, "/"); } else if (last_slash) { *last_slash = '\0'; } }
         print("Changed directory to: "); print(current_directory); print("\n"); return;
     }
-    char full_path[64]; if (dirname[0] == '/') { strcpy(full_path, dirname); } else { strcpy(full_path, current_directory); if (current_directory[strlen(current_directory) - 1] != '/') { strcat(full_path, "/"); } strcat(full_path, dirname); }
+    char* full_path = shell_resolve_path(dirname);
+    if (!full_path) return;
+    if (strlen(full_path) >= sizeof(current_directory)) { print("Path too long: "); print(full_path); print("\n"); return; }
     if (fs_any_exists(full_path) && fs_any_is_directory(full_path)) { strcpy(current_directory, full_path); print("Changed directory to: "); print(current_directory); print("\n"); }
     else { print("Directory not found: "); print(full_path); print("\n"); }
 }
@@ -380,15 +441,8 @@ void cmd_rm(char* args) {
         return;
     }
     // Path oluştur
-    char full_path[64];
-    if (filename[0] == '/') {
-        strcpy(full_path, filename);
-    } else {
-        strcpy(full_path, current_directory);
-        if (current_directory[strlen(current_directory) - 1] != '/')
-            strcat(full_path, "/");
-        strcat(full_path, filename);
-    }
+    char* full_path = shell_resolve_path(filename);
+    if (!full_path) return;
     int res = fs_delete_file(full_path, recursive);
     if (res == 0) {
         print("Removed: "); print(full_path); print("\n");
@@ -402,7 +456,8 @@ void cmd_rm(char* args) {
 }
 
 void cmd_touch(char* filename) {
-    char full_path[64]; if (filename[0] == '/') { strcpy(full_path, filename); } else { strcpy(full_path, current_directory); if (current_directory[strlen(current_directory) - 1] != '/') { strcat(full_path, "/"); } strcat(full_path, filename); }
+    char* full_path = shell_resolve_path(filename);
+    if (!full_path) return;
     if (fs_any_exists(full_path)) { print("touch: file exists: "); print(full_path); print("\n"); return; }
     if (fs_create_file(full_path, "", 0) == 0) { print("Created file: "); print(full_path); print("\n"); }
     else { print("Failed to create file: "); print(full_path); print("\n"); }
@@ -434,23 +489,134 @@ void cmd_disktest() {
     }
 }
 
-// Simple delay function for banner animation
-static void banner_delay(int ms) {
-    for (volatile int i = 0; i < ms * 7000; i++) {
-        __asm__ volatile("nop");
+void cmd_membench() {
+    memory_benchmark();
+}
+
+void cmd_timertest() {
+    timer_selftest();
+}
+
+void cmd_forkbench(char* args) {
+    uint32_t n = 0;
+    while (*args == ' ') args++;
+    while (*args >= '0' && *args <= '9') n = n * 10 + (*args++ - '0');
+    process_fork_benchmark(n);
+}
+
+void cmd_schedbench(char* args) {
+    uint32_t n = 0;
+    while (*args == ' ') args++;
+    while (*args >= '0' && *args <= '9') n = n * 10 + (*args++ - '0');
+    process_sched_benchmark(n);
+}
+
+void cmd_fbbench(char* args) {
+    uint32_t n = 0;
+    while (*args == ' ') args++;
+    while (*args >= '0' && *args <= '9') n = n * 10 + (*args++ - '0');
+    vga_fill_benchmark(n);
+}
+
+void cmd_meminfo() {
+    struct heap_stats hs;
+    struct pmm_stats ps;
+    struct pagecache_stats cs;
+    memory_get_stats(&hs);
+    pmm_get_stats(&ps);
+    pagecache_get_stats(&cs);
+
+    z_printf("Pages: %u KB total, %u KB free, largest block %u KB\n",
+             ps.total_pages * (PAGE_SIZE / 1024), ps.free_pages * (PAGE_SIZE / 1024),
+             ps.largest_order < 0 ? 0 : (PAGE_SIZE / 1024) << ps.largest_order);
+    z_printf("Heap:  %u KB in use, peak %u KB, %u failed allocations\n",
+             hs.bytes_in_use / 1024, hs.peak_bytes / 1024, hs.failed_allocs);
+    z_printf("       %u regions, %u free blocks, largest free %u KB\n",
+             hs.heap_regions, hs.free_blocks, hs.largest_free / 1024);
+    z_printf("Page cache: %u KB read from device, %u ramdisk pages, %u hits, %u misses\n",
+             cs.pages * (PAGE_SIZE / 1024), cs.resident, cs.hits, cs.misses);
+
+    print("Allocations by size:\n");
+    for (int i = 0; i < HEAP_STAT_BUCKETS; i++) {
+        if (!hs.alloc_count[i]) continue;
+        uint32_t limit = 16u << i;
+        if (i == HEAP_STAT_BUCKETS - 1) z_printf("  >%u KB: %u\n", (limit >> 1) / 1024, hs.alloc_count[i]);
+        else if (limit < 1024) z_printf("  <=%u B: %u\n", limit, hs.alloc_count[i]);
+        else z_printf("  <=%u KB: %u\n", limit / 1024, hs.alloc_count[i]);
+    }
+}
+
+// Kernel stack: en derin kullanım / boy; user stack: dokunulduğu kadar
+// büyüdüğü boy. Kernel process'i boot stack'inde, onunki ölçülmüyor.
+void cmd_ps() {
+    static const char* states[] = { "ready", "run", "block", "exit" };
+    struct process_stats stats[32];
+    int n = process_get_stats(stats, 32);
+
+    for (int i = 0; i < n; i++) {
+        struct process_stats* st = &stats[i];
+        z_printf("%u %s %s", st->pid, st->name,
+                 st->state <= PROCESS_TERMINATED ? states[st->state] : "?");
+        if (st->kstack_size) z_printf(", kstack %u/%u B", st->kstack_used, st->kstack_size);
+        if (st->ustack_size) z_printf(", ustack %u KB", st->ustack_size / 1024);
+        print("\n");
     }
 }
 
 #define MAX_BANNER_FRAMES_CHECK 100  // Should match banner.c
 
+// Arka planda çalışan banner animasyonu: banner_stop'a kadar kareleri
+// çizer, aralarda uyur (durdurmak için en fazla 50ms beklenir). Banner
+// sabit anim->y'ye çizilir; ekran kayar ya da temizlenirse oradaki artık
+// başka metindir, animasyon kendiliğinden durur.
+static struct banner* volatile bg_banner = 0;
+static volatile int banner_stop = 0;
+
+static void banner_work(void* arg) {
+    struct banner* anim = (struct banner*)arg;
+    uint32_t last_frame = 0xFFFFFFFF;
+    uint32_t scrolls = get_scroll_count();
+
+    while (!banner_stop && get_scroll_count() == scrolls && anim->frames && anim->num_frames) {
+        // Update banner animation (frame delays are measured in timer ticks)
+        banner_update(anim);
+        
+        // Only redraw if frame changed (efficiency optimization - most important!)
+        if (anim->current_frame != last_frame && 
+            anim->current_frame < anim->num_frames &&
+            anim->frames[anim->current_frame].pixels != 0) {
+            banner_draw(anim);
+            last_frame = anim->current_frame;
+        }
+        
+        uint32_t wait_ms = banner_ms_until_next(anim);
+        process_msleep(wait_ms < 50 ? (wait_ms ? wait_ms : 1) : 50);
+    }
+
+    // Kullanıcı durdurduysa son kare silinir; cursor zaten banner'ın altında
+    if (get_scroll_count() == scrolls && anim->num_frames && anim->frames[0].pixels) {
+        vga_clear_rows(anim->y, (int)anim->frames[0].height);
+    }
+    banner_cleanup(anim);
+    kfree(anim);
+    bg_banner = 0;
+}
+
+// banner: animasyonu başlat, çalışıyorsa durdur
 void cmd_banner() {
+    if (bg_banner) {
+        banner_stop = 1;
+        while (bg_banner) process_msleep(10);
+        print("Banner animation stopped.\n");
+        return;
+    }
+
     // Get cursor position BEFORE printing anything - this is where the command was entered
     int start_cursor_x = get_cursor_x();
     int start_cursor_y = get_cursor_y();
     
     print("Banner: Starting...\n");
     
-    struct banner anim_banner;
     extern uint32_t fb_width;
     extern uint32_t fb_height;
     
@@ -465,12 +631,18 @@ void cmd_banner() {
     int banner_x = 0;  // Start at left edge (like text output)
     int banner_y = 0;  // Will be calculated after we print status messages
     
-    // Initialize banner
-    banner_init(&anim_banner, banner_x, banner_y);
+    // Initialize banner (animasyon bitene kadar worker'ın elinde)
+    struct banner* anim = (struct banner*)kmalloc(sizeof(struct banner));
+    if (!anim) {
+        print_color("Banner: Out of memory\n", VGA_COLOR_LIGHT_RED);
+        return;
+    }
+    banner_init(anim, banner_x, banner_y);
     
     // Safety check - make sure frames array is initialized
-    if (!anim_banner.frames) {
+    if (!anim->frames) {
         print_color("Banner: Failed to initialize frames array\n", VGA_COLOR_LIGHT_RED);
+        kfree(anim);
         return;
     }
     
@@ -483,7 +655,7 @@ void cmd_banner() {
     // Try loading frames one at a time, very carefully
     for (int i = 0; i < 10; i++) {
         int loaded_this_frame = 0;
-        uint32_t num_frames_before = anim_banner.num_frames;
+        uint32_t num_frames_before = anim->num_frames;
         
         // Try pattern 1: /BANNER_0.BIN, /BANNER_1.BIN, etc. (uppercase, simple)
         // Build path safely - ensure null termination
@@ -504,23 +676,23 @@ void cmd_banner() {
         
         // Try to load frame with first pattern - wrap in safety
         // Check if file exists first to avoid crashes
-        if (i < MAX_BANNER_FRAMES_CHECK && anim_banner.frames) {
+        if (i < MAX_BANNER_FRAMES_CHECK && anim->frames) {
             // Try to load frame - this might crash if file is invalid
             // Wrap in as much safety as possible
             print("Banner: Trying to load frame ");
             putchar('0' + i);
             print("...\n");
             
-            banner_load_frame(&anim_banner, i, frame_path);
+            banner_load_frame(anim, i, frame_path);
             
             // Check if frame was loaded - be very careful
-            if (anim_banner.num_frames > num_frames_before && 
-                anim_banner.num_frames > (uint32_t)i &&
+            if (anim->num_frames > num_frames_before && 
+                anim->num_frames > (uint32_t)i &&
                 i < MAX_BANNER_FRAMES_CHECK &&
-                anim_banner.frames) {
+                anim->frames) {
                 // Double-check bounds before accessing
-                if ((uint32_t)i < anim_banner.num_frames) {
-                    if (anim_banner.frames[i].pixels != 0) {
+                if ((uint32_t)i < anim->num_frames) {
+                    if (anim->frames[i].pixels != 0) {
                         frames_loaded++;
                         loaded_this_frame = 1;
                         print("Banner: Frame ");
@@ -532,7 +704,7 @@ void cmd_banner() {
         }
         
         // If pattern 1 failed, try pattern 2
-        if (!loaded_this_frame && i < MAX_BANNER_FRAMES_CHECK && anim_banner.frames) {
+        if (!loaded_this_frame && i < MAX_BANNER_FRAMES_CHECK && anim->frames) {
             // Try pattern 2: /banner_frame_000.bin, etc.
             frame_path[0] = '/';
             frame_path[1] = 'b';
@@ -558,14 +730,14 @@ void cmd_banner() {
             frame_path[21] = '\0';
             
             // Try to load frame with second pattern
-            banner_load_frame(&anim_banner, i, frame_path);
+            banner_load_frame(anim, i, frame_path);
             
             // Check safely
-            if (anim_banner.num_frames > num_frames_before && 
-                anim_banner.num_frames > (uint32_t)i &&
-                anim_banner.frames) {
-                if ((uint32_t)i < anim_banner.num_frames) {
-                    if (anim_banner.frames[i].pixels != 0) {
+            if (anim->num_frames > num_frames_before && 
+                anim->num_frames > (uint32_t)i &&
+                anim->frames) {
+                if ((uint32_t)i < anim->num_frames) {
+                    if (anim->frames[i].pixels != 0) {
                         frames_loaded++;
                         loaded_this_frame = 1;
                     }
@@ -584,14 +756,16 @@ void cmd_banner() {
         print_color("Banner: No frames found.\n", VGA_COLOR_LIGHT_RED);
         print("Expected: /BANNER_0.BIN, /BANNER_1.BIN, etc. or /banner_frame_000.bin, /banner_frame_001.bin, etc.\n");
         print("Make sure banner frames are in the filesystem.\n");
-        banner_cleanup(&anim_banner);
+        banner_cleanup(anim);
+        kfree(anim);
         return;
     }
     
     // Double check frames are valid
-    if (!anim_banner.frames || anim_banner.num_frames == 0) {
+    if (!anim->frames || anim->num_frames == 0) {
         print_color("Banner: Frames array invalid\n", VGA_COLOR_LIGHT_RED);
-        banner_cleanup(&anim_banner);
+        banner_cleanup(anim);
+        kfree(anim);
         return;
     }
     
@@ -611,7 +785,7 @@ void cmd_banner() {
             putchar(digits[j]);
         }
     }
-    print(" frames. Press any key to stop...\n");
+    print(" frames. Run 'banner' again to stop\n");
     
     // Get current cursor position after all status messages
     int end_cursor_y = get_cursor_y();
@@ -632,13 +806,13 @@ void cmd_banner() {
     }
     
     // Update banner position (it was initialized with 0, now set actual position)
-    anim_banner.x = banner_x;
-    anim_banner.y = banner_y;
+    anim->x = banner_x;
+    anim->y = banner_y;
     
     // Get actual banner height from first frame (if available)
     int banner_height = 98;  // Default
-    if (anim_banner.frames && anim_banner.frames[0].pixels != 0) {
-        banner_height = (int)anim_banner.frames[0].height;
+    if (anim->frames && anim->frames[0].pixels != 0) {
+        banner_height = (int)anim->frames[0].height;
     }
     
     // Move cursor BELOW the banner so text doesn't overlap it
@@ -647,55 +821,16 @@ void cmd_banner() {
     // Add 1 line spacing below banner
     move_cursor(0, banner_bottom_line + 1);
     
-    // Activate banner
-    banner_set_active(&anim_banner, 1);
-    
-    // Simple animation loop - runs forever until keypress
-    uint32_t last_frame = 0xFFFFFFFF;
-    
-    while (1) {  // Run forever until keypress
-        // Poll keyboard for input (non-blocking) - check every iteration for responsiveness
-        keyboard_poll();
-        char key = keyboard_get_char();
-        if (key != 0 && key != '\n' && key != '\r') {
-            break;  // User pressed a key, exit animation
-        }
-        
-        // Safety check before updating
-        if (!anim_banner.frames || anim_banner.num_frames == 0) {
-            break;  // Banner became invalid
-        }
-        
-        // Update banner animation (timing is counter-based, so frequent calls are needed)
-        banner_update(&anim_banner);
-        
-        // Only redraw if frame changed (efficiency optimization - most important!)
-        if (anim_banner.current_frame != last_frame && 
-            anim_banner.current_frame < anim_banner.num_frames &&
-            anim_banner.frames[anim_banner.current_frame].pixels != 0) {
-            banner_draw(&anim_banner);
-            last_frame = anim_banner.current_frame;
-        }
-        
-        // Very small delay to prevent CPU spinning (banner timing is counter-based, not real-time)
-        banner_delay(1);  // 1ms delay - minimal CPU usage
-    }
-    
-    // Save banner position and height before cleanup (for cursor positioning)
-    int final_banner_y = anim_banner.y;
-    int final_banner_height = 98;  // Default
-    if (anim_banner.frames && anim_banner.frames[0].pixels != 0) {
-        final_banner_height = (int)anim_banner.frames[0].height;
+    // Animasyon arka planda: shell hemen prompt'a döner
+    banner_set_active(anim, 1);
+    banner_stop = 0;
+    bg_banner = anim;
+    if (queue_work(banner_work, anim) < 0) {
+        bg_banner = 0;
+        banner_cleanup(anim);
+        kfree(anim);
+        print_color("Banner: Could not start animation\n", VGA_COLOR_LIGHT_RED);
     }
-    
-    // Cleanup
-    banner_cleanup(&anim_banner);
-    
-    // Move cursor below the banner area so prompt appears in correct place
-    int final_banner_bottom_line = (final_banner_y + final_banner_height) / 16;
-    move_cursor(0, final_banner_bottom_line + 1);
-    
-    print("Banner animation stopped.\n");
 }
 
 int shell_readline(char* buf, int maxlen) {
@@ -703,7 +838,9 @@ int shell_readline(char* buf, int maxlen) {
     history_index = history_count; // virtual index after last entry
     while (1) {
         char c = keyboard_get_char();
-        if (!c) { keyboard_poll(); continue; }
+        // Tuş beklerken boş sayfaları kcalloc/kpage_zalloc için önceden sıfırla,
+        // o da bitince CPU'yu tuş gelene kadar durdur
+        if (!c) { if (!pmm_zero_idle(1)) keyboard_wait(); continue; }
         if (c == '\n' || c == '\r') {
             if (pos < maxlen) buf[pos] = '\0'; else buf[maxlen-1] = '\0';
             putchar('\n');
@@ -50,5 +50,12 @@ void cmd_mkdirfat32(char* dirname);
 void cmd_touchfat32(char* filename);
 void cmd_cdfat32(char* dirname);
 void cmd_banner();
+void cmd_membench();
+void cmd_meminfo();
+void cmd_ps();
+void cmd_timertest();
+void cmd_forkbench(char* args);
+void cmd_schedbench(char* args);
+void cmd_fbbench(char* args);
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,49 @@
+; Context switch: kernel stack'ler arası geçiş
+; Process'in user register'ları kesildiği anda kernel stack'indeki struct
+; regs'te durur; burada sadece callee-saved register'lar ve eflags (IF)
+; saklanır. Yeni process'in stack'i process.c'de aynı düzende hazırlanır.
+
+section .text
+global switch_context
+global process_fork_return
+global process_thread_start
+extern process_thread_exit
+
+; void switch_context(uint32_t* old_esp, uint32_t new_esp)
+switch_context:
+    mov eax, [esp + 4]
+    mov edx, [esp + 8]
+    push ebp
+    push ebx
+    push esi
+    push edi
+    pushfd
+    mov [eax], esp          ; Eski process'in kaldığı yer
+    mov esp, edx
+    popfd
+    pop edi
+    pop esi
+    pop ebx
+    pop ebp
+    ret
+
+; Fork'lanan child ilk kez buraya döner: stack'te parent'ın frame kopyası
+; (eax = 0) var, isr_common_stub'ın çıkışı gibi iret ile user'a iner
+process_fork_return:
+    pop eax
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    popa
+    add esp, 8              ; int_no ve err_code
+    iret
+
+; Kernel thread'i ilk kez buraya döner: stack'te entry ve argümanı var
+process_thread_start:
+    pop eax                 ; entry
+    call eax                ; argüman stack'te duruyor
+    call process_thread_exit
+.hang:
+    hlt
+    jmp .hang
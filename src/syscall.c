@@ -5,6 +5,9 @@
 #include "memory.h"
 #include "elf.h"
 #include "interrupts.h"
+#include "paging.h"
+#include "vm.h"
+#include "timer.h"
 
 // External variables from elf.c
 extern int program_exit_requested;
@@ -24,6 +27,8 @@ static struct {
 
 static int next_fd = 3;  // Start after stdin/stdout/stderr
 
+struct regs* syscall_frame = 0;
+
 void syscall_init() {
     // Initialize file descriptor table
     for (int i = 0; i < MAX_FDS; i++) {
@@ -44,32 +49,94 @@ void syscall_init() {
     fd_table[FD_STDERR].mode = 1;  // O_WRONLY
 }
 
+// User string'ini arenaya kopyala (en fazla max - 1 karakter, her zaman NUL ile biter)
+static char* syscall_copy_string(struct arena* a, const char* src, int max) {
+    int len = 0;
+    while (len < max - 1 && src[len]) len++;
+    char* dst = (char*)arena_alloc(a, len + 1);
+    if (!dst) return 0;
+    for (int i = 0; i < len; i++) dst[i] = src[i];
+    dst[len] = 0;
+    return dst;
+}
+
+// timespec/timeval süresini yukarı yuvarlanmış tick'e çevir; çok uzun
+// süreler timer wheel'in işaretli karşılaştırması için kırpılır
+#define SLEEP_MAX_TICKS 0x3FFFFFFF
+
+static uint32_t syscall_to_ticks(uint32_t sec, uint32_t nsec) {
+    if (sec >= SLEEP_MAX_TICKS / TIMER_HZ) return SLEEP_MAX_TICKS;
+    return sec * TIMER_HZ + (nsec + TIMER_TICK_NSEC - 1) / TIMER_TICK_NSEC;
+}
+
+// ticks'i struct timeval'a ({ tv_sec, tv_usec }) yaz
+static void syscall_ticks_to_timeval(uint32_t ticks, uint32_t* tv) {
+    tv[0] = ticks / TIMER_HZ;
+    tv[1] = (ticks % TIMER_HZ) * (1000000 / TIMER_HZ);
+}
+
+// ticks kadar uyu; sinyalle erken biterse kalan süre rem'e (timespec) yazılır
+static int32_t syscall_sleep(uint32_t ticks, uint32_t* rem) {
+    uint32_t left = process_sleep(ticks);
+    if (!left) return 0;
+    if (rem) {
+        rem[0] = left / TIMER_HZ;
+        rem[1] = (left % TIMER_HZ) * (1000000000 / TIMER_HZ);
+    }
+    return -4;  // EINTR
+}
+
+// mmap: anonim ya da dosya eşlemesi, sayfalar ilk erişimde doldurulur.
+// ISO dosyaları page cache'ten eşlenir (read-only sayfalar cache'in ya da
+// ramdisk'in sayfası, kopya yok); TinyFS dosyaları eşleme anında kopyalanır.
+// Dosyaya geri yazan MAP_SHARED + PROT_WRITE desteklenmiyor.
+static int32_t syscall_mmap(uint32_t addr, uint32_t len, uint32_t prot, uint32_t flags, int fd, uint32_t offset) {
+    struct mm* mm = mm_current();
+    if (!mm) return -12;  // ENOMEM
+    if (!len || (offset & (PAGE_SIZE - 1))) return -22;  // EINVAL
+    uint32_t vm_flags = prot & VM_ACCESS;
+    int fixed = (flags & MAP_FIXED) != 0;
+    uint32_t va;
+
+    if (flags & MAP_ANONYMOUS) {
+        va = mm_mmap(mm, addr, len, vm_flags, fixed, 0, 0);
+        return va ? (int32_t)va : -12;
+    }
+    if (fd < 0 || fd >= MAX_FDS || !fd_table[fd].used || !fd_table[fd].path) return -9;  // EBADF
+    if ((flags & MAP_SHARED) && (prot & PROT_WRITE)) return -13;  // EACCES
+
+    uint32_t dev, dev_offset, size;
+    if (fs_file_cache_extent(fd_table[fd].path, &dev, &dev_offset, &size) == 0) {
+        uint32_t pages = (len + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+        va = mm_get_unmapped_area(mm, addr, pages, fixed);
+        if (!va || mm_map_cache(mm, va, pages, vm_flags, dev, dev_offset + offset,
+                                offset < size ? size - offset : 0) < 0) return -12;
+        return (int32_t)va;
+    }
+
+    int file_size = fs_get_file_size(fd_table[fd].path);
+    if (file_size < 0) return -2;  // ENOENT
+    va = mm_mmap(mm, addr, len, vm_flags, fixed, 0, 0);
+    if (!va) return -12;
+    if (offset < (uint32_t)file_size) {
+        char* buf = (char*)kmalloc((uint32_t)file_size);
+        int n = buf ? fs_read_file(fd_table[fd].path, buf, (uint32_t)file_size) : -1;
+        uint32_t copy = n > (int)offset ? (uint32_t)n - offset : 0;
+        if (copy > len) copy = len;
+        if (n < 0 || (copy && mm_load_file(mm, va, copy, vm_flags, (uint8_t*)buf + offset, copy) < 0)) {
+            kfree(buf);
+            mm_unmap(mm, va, (len + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1));
+            return -12;
+        }
+        kfree(buf);
+    }
+    return (int32_t)va;
+}
+
 // Syscall handler - handles all Linux syscalls
 int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4, uint32_t arg5, uint32_t arg6) {
     (void)arg4; (void)arg5; (void)arg6;  // Unused for now
     
-    // Debug: Print syscall number
-    print_color("[SYSCALL ", VGA_COLOR_LIGHT_GREY);
-    char sc_buf[16];
-    int sc_pos = 0;
-    uint32_t sc = syscall_num;
-    if (sc == 0) {
-        sc_buf[sc_pos++] = '0';
-    } else {
-        char digits[16];
-        int dpos = 0;
-        while (sc > 0 && dpos < 15) {
-            digits[dpos++] = '0' + (sc % 10);
-            sc /= 10;
-        }
-        for (int i = dpos - 1; i >= 0; i--) {
-            sc_buf[sc_pos++] = digits[i];
-        }
-    }
-    sc_buf[sc_pos] = '\0';
-    print(sc_buf);
-    print("]\n");
-    
     switch (syscall_num) {
         case SYS_EXIT:
         case SYS_EXIT_GROUP:
@@ -99,6 +166,9 @@ int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint3
             code_buf[pos] = '\0';
             print(code_buf);
             print("]\n");
+
+            // Fork'lanmış child: zombie olur, scheduler başka process'e geçer (dönmez)
+            process_exit_child((int)arg1);
             
             // Set exit flag - interrupt handler will modify return EIP
             program_exit_requested = 1;
@@ -192,8 +262,7 @@ int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint3
             }
             
         case SYS_GETPID:
-            // Return process ID (simplified)
-            return 1;
+            return current_process ? (int32_t)current_process->pid : 1;
             
         case SYS_GETUID:
             return 0;  // root
@@ -293,20 +362,57 @@ int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint3
             
         case SYS_TIME:
             {
+                // vDSO'daki __vdso_time ile aynı saat
+                uint32_t sec, nsec;
+                timer_get_realtime(&sec, &nsec);
                 uint32_t* tloc = (uint32_t*)arg1;
-                // Return current time (stub)
-                uint32_t time = 1609459200;  // 2021-01-01 00:00:00 UTC
                 if (tloc) {
-                    *tloc = time;
+                    *tloc = sec;
                 }
-                return time;
+                return (int32_t)sec;
             }
             
         case SYS_GETTIMEOFDAY:
             {
-                // struct timeval* tv = (struct timeval*)arg1;
-                // TODO: Fill timeval
-                return 0;  // Stub
+                // struct timeval { long tv_sec; long tv_usec; }, timezone hep UTC
+                uint32_t* tv = (uint32_t*)arg1;
+                uint32_t* tz = (uint32_t*)arg2;
+                uint32_t sec, nsec;
+                timer_get_realtime(&sec, &nsec);
+                if (tv) {
+                    tv[0] = sec;
+                    tv[1] = nsec / 1000;
+                }
+                if (tz) {
+                    tz[0] = 0;
+                    tz[1] = 0;
+                }
+                return 0;
+            }
+            
+        case SYS_CLOCK_GETTIME:
+            {
+                // struct timespec { long tv_sec; long tv_nsec; }
+                uint32_t* ts = (uint32_t*)arg2;
+                uint32_t sec, nsec;
+                if (!ts) return -14;  // EFAULT
+                switch (arg1) {
+                    case CLOCK_REALTIME:
+                    case CLOCK_REALTIME_COARSE:
+                        timer_get_realtime(&sec, &nsec);
+                        break;
+                    case CLOCK_MONOTONIC:
+                    case CLOCK_MONOTONIC_RAW:
+                    case CLOCK_MONOTONIC_COARSE:
+                    case CLOCK_BOOTTIME:
+                        timer_get_monotonic(&sec, &nsec);
+                        break;
+                    default:
+                        return -22;  // EINVAL
+                }
+                ts[0] = sec;
+                ts[1] = nsec;
+                return 0;
             }
             
         case SYS_UNAME:
@@ -317,18 +423,148 @@ int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint3
             }
             
         case SYS_NANOSLEEP:
-            // Sleep - just return immediately for now
-            return 0;
+            {
+                // ebx = süre, ecx = kalan süre (struct timespec)
+                uint32_t* req = (uint32_t*)arg1;
+                if ((uint32_t)req < 0x1000) return -14;  // EFAULT
+                if ((int)req[0] < 0 || req[1] >= 1000000000) return -22;  // EINVAL
+                return syscall_sleep(syscall_to_ticks(req[0], req[1]), (uint32_t*)arg2);
+            }
+
+        case SYS_CLOCK_NANOSLEEP:
+            {
+                // ebx = clock, ecx = bayraklar, edx = süre, esi = kalan süre
+                uint32_t* req = (uint32_t*)arg3;
+                uint32_t sec = 0, nsec = 0;
+                if ((uint32_t)req < 0x1000) return -14;  // EFAULT
+                if ((int)req[0] < 0 || req[1] >= 1000000000) return -22;  // EINVAL
+                if (arg1 == CLOCK_REALTIME) {
+                    timer_get_realtime(&sec, &nsec);
+                } else if (arg1 == CLOCK_MONOTONIC || arg1 == CLOCK_BOOTTIME) {
+                    timer_get_monotonic(&sec, &nsec);
+                } else {
+                    return -22;  // EINVAL
+                }
+                if (!(arg2 & TIMER_ABSTIME)) return syscall_sleep(syscall_to_ticks(req[0], req[1]), (uint32_t*)arg4);
+
+                // Mutlak süre: geçmişteyse hemen döner, kalan süre yazılmaz
+                if (req[0] < sec || (req[0] == sec && req[1] <= nsec)) return 0;
+                uint32_t dsec = req[0] - sec;
+                uint32_t dnsec = req[1];
+                if (dnsec < nsec) {
+                    dnsec += 1000000000;
+                    dsec--;
+                }
+                return syscall_sleep(syscall_to_ticks(dsec, dnsec - nsec), 0);
+            }
+
+        case SYS_ALARM:
+            {
+                // ebx = saniye (0 iptal eder); önceki alarmın kalan saniyesi döner
+                uint32_t ticks = syscall_to_ticks(arg1, 0);
+                uint32_t left = process_set_alarm(current_process, ticks, 0, 0);
+                return (int32_t)((left + TIMER_HZ - 1) / TIMER_HZ);
+            }
+
+        case SYS_SETITIMER:
+        case SYS_GETITIMER:
+            {
+                // ebx = which, ecx = yeni (setitimer) ya da sonuç (getitimer),
+                // edx = eski; struct itimerval { it_interval, it_value }
+                uint32_t* nv = (uint32_t*)arg2;
+                uint32_t* ov = syscall_num == SYS_SETITIMER ? (uint32_t*)arg3 : nv;
+                uint32_t interval, left;
+                if (arg1 != ITIMER_REAL) return -22;  // EINVAL: CPU zamanı sayaçları yok
+                if (syscall_num == SYS_GETITIMER) {
+                    if ((uint32_t)ov < 0x1000) return -14;  // EFAULT
+                    left = process_get_alarm(current_process, &interval);
+                } else {
+                    if ((uint32_t)nv < 0x1000) return -14;  // EFAULT
+                    if (nv[1] >= 1000000 || nv[3] >= 1000000) return -22;  // EINVAL
+                    left = process_set_alarm(current_process,
+                                             syscall_to_ticks(nv[2], nv[3] * 1000),
+                                             syscall_to_ticks(nv[0], nv[1] * 1000), &interval);
+                }
+                if (ov) {
+                    syscall_ticks_to_timeval(interval, ov);
+                    syscall_ticks_to_timeval(left, ov + 2);
+                }
+                return 0;
+            }
+
+        case SYS_PAUSE:
+            return process_pause();
+            
+        case SYS_NICE:
+            // ebx = nice artışı (eksi değer önceliği yükseltir)
+            if (!current_process) return -3;  // ESRCH
+            return process_set_nice(current_process, current_process->nice + (int)arg1);
+            
+        case SYS_GETPRIORITY:
+        case SYS_SETPRIORITY:
+            {
+                // ebx = which (sadece PRIO_PROCESS), ecx = pid (0: kendisi), edx = nice
+                if (arg1 != PRIO_PROCESS) return -22;  // EINVAL
+                struct process* p = arg2 ? process_find(arg2) : current_process;
+                if (!p) return -3;  // ESRCH
+                // Linux gibi getpriority 20 - nice döner (1..40, negatif olmasın)
+                if (syscall_num == SYS_GETPRIORITY) return 20 - p->nice;
+                return process_set_nice(p, (int)arg3);
+            }
+            
+        case SYS_SCHED_SETSCHEDULER:
+        case SYS_SCHED_SETPARAM:
+            {
+                // ebx = pid, setscheduler: ecx = policy, edx = param; setparam: ecx = param
+                struct process* p = arg1 ? process_find(arg1) : current_process;
+                if (!p) return -3;  // ESRCH
+                uint32_t policy = syscall_num == SYS_SCHED_SETSCHEDULER ? arg2 : p->policy;
+                int* param = (int*)(syscall_num == SYS_SCHED_SETSCHEDULER ? arg3 : arg2);
+                if (!param) return -22;  // EINVAL
+                if ((uint32_t)param < 0x1000) return -14;  // EFAULT
+                return process_set_scheduler(p, policy, (uint32_t)param[0]);
+            }
+            
+        case SYS_SCHED_GETSCHEDULER:
+        case SYS_SCHED_GETPARAM:
+            {
+                struct process* p = arg1 ? process_find(arg1) : current_process;
+                if (!p) return -3;  // ESRCH
+                if (syscall_num == SYS_SCHED_GETSCHEDULER) return (int32_t)p->policy;
+                int* param = (int*)arg2;
+                if (!param) return -22;  // EINVAL
+                if ((uint32_t)param < 0x1000) return -14;  // EFAULT
+                param[0] = (int)p->rt_priority;
+                return 0;
+            }
+            
+        case SYS_SCHED_GET_PRIORITY_MAX:
+        case SYS_SCHED_GET_PRIORITY_MIN:
+            if (arg1 == SCHED_FIFO || arg1 == SCHED_RR) {
+                return syscall_num == SYS_SCHED_GET_PRIORITY_MAX ? RT_PRIO_MAX : 1;
+            }
+            return arg1 == SCHED_OTHER ? 0 : -22;  // EINVAL
             
         case SYS_SCHED_YIELD:  // SYS_YIELD is an alias (same number 158)
-            // Yield CPU
+            // Slice'ın kalanını READY process'lere bırak
+            process_yield();
             return 0;
             
         case SYS_FORK:
+            // Copy-on-write: sadece page table'lar kopyalanır
+            if (!syscall_frame) return -38;
+            return process_sys_fork(syscall_frame, 0, 0);
+
         case SYS_VFORK:
+            if (!syscall_frame) return -38;
+            return process_sys_fork(syscall_frame, FORK_SHARE_VM | FORK_VFORK, 0);
+
         case SYS_CLONE:
-            // Process creation - not supported yet
-            return -1;  // ENOSYS
+            // ebx = flags, ecx = child stack (0: parent'ınki)
+            if (!syscall_frame) return -38;
+            return process_sys_fork(syscall_frame,
+                                    ((arg1 & CLONE_VM) ? FORK_SHARE_VM : 0) |
+                                    ((arg1 & CLONE_VFORK) ? FORK_VFORK : 0), arg2);
             
         case SYS_EXECVE:
             {
@@ -360,6 +596,11 @@ int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint3
                     return -2;  // ENOENT
                 }
                 
+                // argv/envp kopyaları exec arenasından gelir: her string bir
+                // pointer bump, hata yollarında ve sonunda tek arena_reset
+                static struct arena exec_arena;
+                arena_begin(&exec_arena);
+
                 // Parse argv array from user space
                 // Limit to 64 arguments to prevent excessive memory usage
                 #define MAX_ARGS 64
@@ -381,35 +622,15 @@ int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint3
                         
                         // Validate argument pointer
                         if ((uint32_t)arg_ptr < 0x1000 || (uint32_t)arg_ptr > 0xFFFFFFFF) {
-                            // Free already allocated args
-                            for (int j = 0; j < i; j++) {
-                                kfree(argv_kernel[j]);
-                            }
+                            arena_reset(&exec_arena);
                             return -14;  // EFAULT
                         }
                         
-                        // Allocate kernel space for argument string
-                        char* arg_buf = (char*)kmalloc(256);
+                        char* arg_buf = syscall_copy_string(&exec_arena, arg_ptr, 256);
                         if (!arg_buf) {
-                            // Free already allocated args
-                            for (int j = 0; j < i; j++) {
-                                kfree(argv_kernel[j]);
-                            }
+                            arena_reset(&exec_arena);
                             return -12;  // ENOMEM
                         }
-                        
-                        // Copy argument string
-                        int arg_len = 0;
-                        for (int j = 0; j < 255; j++) {
-                            char c = arg_ptr[j];
-                            arg_buf[j] = c;
-                            if (c == 0) {
-                                arg_len = j;
-                                break;
-                            }
-                        }
-                        arg_buf[255] = 0;
-                        
                         argv_kernel[argc++] = arg_buf;
                     }
                 }
@@ -424,10 +645,7 @@ int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint3
                 if (envp_user) {
                     // Validate envp pointer
                     if ((uint32_t)envp_user < 0x1000 || (uint32_t)envp_user > 0xFFFFFFFF) {
-                        // Free argv strings
-                        for (int i = 0; i < argc; i++) {
-                            kfree(argv_kernel[i]);
-                        }
+                        arena_reset(&exec_arena);
                         return -14;  // EFAULT
                     }
                     
@@ -440,41 +658,15 @@ int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint3
                         
                         // Validate environment variable pointer
                         if ((uint32_t)env_ptr < 0x1000 || (uint32_t)env_ptr > 0xFFFFFFFF) {
-                            // Free argv and envp strings
-                            for (int j = 0; j < argc; j++) {
-                                kfree(argv_kernel[j]);
-                            }
-                            for (int j = 0; j < i; j++) {
-                                kfree(envp_kernel[j]);
-                            }
+                            arena_reset(&exec_arena);
                             return -14;  // EFAULT
                         }
                         
-                        // Allocate kernel space for environment variable string
-                        char* env_buf = (char*)kmalloc(512);
+                        char* env_buf = syscall_copy_string(&exec_arena, env_ptr, 512);
                         if (!env_buf) {
-                            // Free already allocated strings
-                            for (int j = 0; j < argc; j++) {
-                                kfree(argv_kernel[j]);
-                            }
-                            for (int j = 0; j < i; j++) {
-                                kfree(envp_kernel[j]);
-                            }
+                            arena_reset(&exec_arena);
                             return -12;  // ENOMEM
                         }
-                        
-                        // Copy environment variable string
-                        int env_len = 0;
-                        for (int j = 0; j < 511; j++) {
-                            char c = env_ptr[j];
-                            env_buf[j] = c;
-                            if (c == 0) {
-                                env_len = j;
-                                break;
-                            }
-                        }
-                        env_buf[511] = 0;
-                        
                         envp_kernel[envc++] = env_buf;
                     }
                 }
@@ -484,12 +676,7 @@ int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint3
                 int result = elf_load_and_execve(pathname_buf, argv_kernel, envp_kernel);
                 
                 // Free kernel copies of strings
-                for (int i = 0; i < argc; i++) {
-                    kfree(argv_kernel[i]);
-                }
-                for (int i = 0; i < envc; i++) {
-                    kfree(envp_kernel[i]);
-                }
+                arena_reset(&exec_arena);
                 
                 // If execve succeeds, it never returns (process is replaced)
                 // If it fails, return error code
@@ -502,49 +689,45 @@ int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint3
             }
             
         case SYS_WAITPID:
-            // Wait for process - not supported
-            return -1;  // ENOSYS
+        case SYS_WAIT4:
+            // ebx = pid, ecx = status pointer, edx = options
+            return process_wait((int)arg1, (int*)arg2, (int)arg3);
             
         case SYS_KILL:
-            // Send signal - not supported
-            return -1;  // ENOSYS
+            // ebx = pid, ecx = sinyal
+            return process_kill((int)arg1, (int)arg2);
             
         case SYS_MMAP:
+            {
+                // old_mmap: ebx altı argümanlık diziyi gösterir, offset byte
+                uint32_t* args = (uint32_t*)arg1;
+                if ((uint32_t)args < 0x1000) return -14;  // EFAULT
+                return syscall_mmap(args[0], args[1], args[2], args[3], (int)args[4], args[5]);
+            }
+
         case SYS_MMAP2:
+            // Offset 4KB'lık sayfa cinsinden
+            return syscall_mmap(arg1, arg2, arg3, arg4, (int)arg5, arg6 * PAGE_SIZE);
+
         case SYS_MUNMAP:
-            // Memory mapping - simplified
-            if (syscall_num == SYS_MMAP || syscall_num == SYS_MMAP2) {
-                void* addr = (void*)arg1;
-                uint32_t len = arg2;
-                int prot = (int)arg3;
-                int flags = (int)arg4;
-                int fd = (int)arg5;
-                uint32_t offset = arg6;
-                
-                (void)prot; (void)flags; (void)fd; (void)offset;
-                
-                // Simple allocation
-                if (addr == 0) {
-                    void* ptr = kmalloc(len);
-                    return (int32_t)ptr;
-                }
-                return (int32_t)addr;
-            } else {
-                // munmap
-                kfree((void*)arg1);
-                return 0;
+            {
+                struct mm* mm = mm_current();
+                if (!mm || !arg2) return -22;  // EINVAL
+                return mm_unmap(mm, arg1, (arg2 + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1)) < 0 ? -22 : 0;
+            }
+
+        case SYS_MPROTECT:
+            {
+                struct mm* mm = mm_current();
+                if (!mm) return -22;  // EINVAL
+                return mm_protect(mm, arg1, (arg2 + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1), arg3 & VM_ACCESS) < 0 ? -22 : 0;
             }
             
         case SYS_BRK:
-            // Memory allocation - use our kmalloc
+            // Her process'in kendi heap'i; arg1 0 ise sadece mevcut break
             {
-                static uint32_t program_break = 0x500000;  // Start at 5MB
-                if (arg1 == 0) {
-                    return program_break;  // Get current break
-                }
-                // Set new break (simplified)
-                program_break = arg1;
-                return program_break;
+                struct mm* mm = mm_current();
+                return mm ? (int32_t)mm_brk(mm, arg1) : 0;
             }
             
         default:
@@ -372,6 +372,44 @@ typedef int int32_t;
 #define SYS_PIDFD_OPEN       434
 #define SYS_CLONE3           435
 
+// mmap/mprotect bayrakları (Linux i386 değerleri)
+#define PROT_NONE    0x0
+#define PROT_READ    0x1
+#define PROT_WRITE   0x2
+#define PROT_EXEC    0x4
+#define MAP_SHARED   0x01
+#define MAP_PRIVATE  0x02
+#define MAP_FIXED    0x10
+#define MAP_ANONYMOUS 0x20
+
+// clock_gettime clock id'leri
+#define CLOCK_REALTIME          0
+#define CLOCK_MONOTONIC         1
+#define CLOCK_MONOTONIC_RAW     4
+#define CLOCK_REALTIME_COARSE   5
+#define CLOCK_MONOTONIC_COARSE  6
+#define CLOCK_BOOTTIME          7
+
+// clock_nanosleep bayrakları
+#define TIMER_ABSTIME           1
+
+// setitimer/getitimer 'which' değerleri (sadece ITIMER_REAL var)
+#define ITIMER_REAL             0
+#define ITIMER_VIRTUAL          1
+#define ITIMER_PROF             2
+
+// getpriority/setpriority 'which' değerleri
+#define PRIO_PROCESS            0
+
+// clone() bayrakları
+#define CLONE_VM             0x00000100
+#define CLONE_VFORK          0x00004000
+
+struct regs;
+
+// int 0x80 frame'i; fork/exit çağıranın register'larını değiştirir
+extern struct regs* syscall_frame;
+
 // Syscall handler function
 int32_t handle_syscall(uint32_t syscall_num, uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4, uint32_t arg5, uint32_t arg6);
 
@@ -0,0 +1,401 @@
+#include "timer.h"
+#include "io.h"
+#include "vdso.h"
+#include "z_utils.h"
+
+// PIT kanal 0 iş varken TIMER_HZ'de periyodik çalışır; her tick monotonic
+// saati ilerletir, süresi dolan timer'ları çalıştırır ve vDSO veri sayfasına
+// yazar. CPU boştayken (timer_idle) periyodik tick kapatılır, PIT bir
+// sonraki timer'a (ya da en uzun süreye) one-shot kurulur; uyanınca geçen
+// süre sayaçtan okunup saate eklenir. Saat PIT sayımı cinsinden tutulur,
+// tick altı artık kaybolmaz. Duvar saati boot'ta CMOS RTC'den bir kere
+// okunur, sonrası monotonic + boot_epoch.
+
+#define CMOS_ADDR       0x70
+#define CMOS_DATA       0x71
+#define PIT_CH0         0x40
+#define PIT_CMD         0x43
+#define PIC1_COMMAND    0x20
+
+static volatile uint32_t ticks = 0;
+static uint32_t mono_sec = 0;
+static uint32_t mono_nsec = 0;
+static uint32_t boot_epoch = 0;
+static uint32_t tick_counts = 0;        // Mevcut tick'te geçmiş PIT sayımı
+static int oneshot = 0;                 // PIT şu an one-shot modunda
+static uint32_t oneshot_counts = 0;     // One-shot'a yüklenen sayım
+
+static uint32_t irq_save();
+static void irq_restore(uint32_t flags);
+
+// --- Timer wheel ---
+//
+// Hiyerarşik: tv1'de önümüzdeki 256 tick'in her biri için bir slot, tvn[0..3]
+// 64'er slotla sırayla 2^14, 2^20, 2^26 ve 2^32 tick'e kadar olanları tutar.
+// Ekleme ve silme O(1); tv1'in indeksi 0'a dönünce üst seviyenin sıradaki
+// slotu aşağı dağıtılır (cascade). wheel_base işlenecek sıradaki tick.
+
+#define TVR_BITS    8
+#define TVN_BITS    6
+#define TVR_SIZE    (1 << TVR_BITS)
+#define TVN_SIZE    (1 << TVN_BITS)
+#define TVR_MASK    (TVR_SIZE - 1)
+#define TVN_MASK    (TVN_SIZE - 1)
+#define TVN_INDEX(base, n)  (((base) >> (TVR_BITS + (n) * TVN_BITS)) & TVN_MASK)
+
+static struct ktimer* tv1[TVR_SIZE];
+static struct ktimer* tvn[4][TVN_SIZE];
+static uint32_t wheel_base = 1;
+
+static void slot_insert(struct ktimer** slot, struct ktimer* t) {
+    t->next = *slot;
+    if (t->next) t->next->pprev = &t->next;
+    t->pprev = slot;
+    *slot = t;
+}
+
+static void slot_remove(struct ktimer* t) {
+    *t->pprev = t->next;
+    if (t->next) t->next->pprev = t->pprev;
+    t->next = 0;
+    t->pprev = 0;
+}
+
+static void wheel_insert(struct ktimer* t) {
+    uint32_t expires = t->expires;
+    uint32_t idx = expires - wheel_base;
+    struct ktimer** slot;
+    if ((int)idx < 0) {
+        slot = &tv1[wheel_base & TVR_MASK];     // Zamanı geçmiş: sıradaki tick'te
+    } else if (idx < 1u << TVR_BITS) {
+        slot = &tv1[expires & TVR_MASK];
+    } else if (idx < 1u << (TVR_BITS + TVN_BITS)) {
+        slot = &tvn[0][TVN_INDEX(expires, 0)];
+    } else if (idx < 1u << (TVR_BITS + 2 * TVN_BITS)) {
+        slot = &tvn[1][TVN_INDEX(expires, 1)];
+    } else if (idx < 1u << (TVR_BITS + 3 * TVN_BITS)) {
+        slot = &tvn[2][TVN_INDEX(expires, 2)];
+    } else {
+        slot = &tvn[3][TVN_INDEX(expires, 3)];
+    }
+    slot_insert(slot, t);
+}
+
+// Üst seviyedeki bir slotun timer'larını yeniden dağıt; slot indeksini döner
+static uint32_t wheel_cascade(int level, uint32_t index) {
+    struct ktimer* t = tvn[level][index];
+    tvn[level][index] = 0;
+    while (t) {
+        struct ktimer* next = t->next;
+        wheel_insert(t);
+        t = next;
+    }
+    return index;
+}
+
+// wheel_base tick'ini işle: gerekiyorsa cascade, sonra slottaki timer'ları
+// çalıştır. Slot önce yerel listeye alınır: callback'ten TVR_SIZE tick
+// sonrasına kurulan timer aynı slota düşer ve bu tick'te tekrar
+// çalışmamalı. Henüz çalışmamış timer'ların pprev'i yerel listeyi gösterir,
+// callback'ler onları da timer_del ile silebilir.
+static void wheel_run() {
+    uint32_t index = wheel_base & TVR_MASK;
+    if (!index &&
+        !wheel_cascade(0, TVN_INDEX(wheel_base, 0)) &&
+        !wheel_cascade(1, TVN_INDEX(wheel_base, 1)) &&
+        !wheel_cascade(2, TVN_INDEX(wheel_base, 2))) {
+        wheel_cascade(3, TVN_INDEX(wheel_base, 3));
+    }
+    wheel_base++;
+
+    struct ktimer* pending = tv1[index];
+    tv1[index] = 0;
+    if (pending) pending->pprev = &pending;
+    while (pending) {
+        struct ktimer* t = pending;
+        slot_remove(t);
+        t->fn(t->arg);
+    }
+}
+
+// Sıradaki en fazla max tick içinde süresi dolacak timer kaç tick sonra?
+// tv1 dışındakiler ancak cascade'le gelir, cascade tick'i de sayılır.
+static uint32_t wheel_next_expiry(uint32_t max) {
+    for (uint32_t k = 0; k < max; k++) {
+        uint32_t index = (wheel_base + k) & TVR_MASK;
+        if (tv1[index] || !index) return k + 1;
+    }
+    return max;
+}
+
+void timer_setup(struct ktimer* t, void (*fn)(void* arg), void* arg) {
+    t->expires = 0;
+    t->fn = fn;
+    t->arg = arg;
+    t->next = 0;
+    t->pprev = 0;
+}
+
+// expires (mutlak tick) geldiğinde fn(arg), interrupt'lar kapalıyken
+// çağrılır. Kurulu timer'ın süresi değişir.
+void timer_add(struct ktimer* t, uint32_t expires) {
+    uint32_t flags = irq_save();
+    if (t->pprev) slot_remove(t);
+    t->expires = expires;
+    wheel_insert(t);
+    irq_restore(flags);
+}
+
+// Kuruluysa iptal et; kuruluysa 1 döner
+int timer_del(struct ktimer* t) {
+    uint32_t flags = irq_save();
+    int pending = t->pprev != 0;
+    if (pending) slot_remove(t);
+    irq_restore(flags);
+    return pending;
+}
+
+// Regresyon testi: callback'inden TVR_SIZE tick sonrasına yeniden kurulan
+// timer aynı tv1 slotuna düşer; bir sonraki turda, tam TVR_SIZE tick
+// sonra çalışmalı, aynı tick'te ikinci kez değil.
+static uint32_t selftest_fired[3];
+static volatile uint32_t selftest_count;
+
+static void selftest_fn(void* arg) {
+    struct ktimer* t = (struct ktimer*)arg;
+    if (selftest_count < 3) selftest_fired[selftest_count] = ticks;
+    selftest_count++;
+    if (selftest_count == 1) timer_add(t, t->expires + TVR_SIZE);
+}
+
+int timer_selftest() {
+    struct ktimer t;
+    timer_setup(&t, selftest_fn, &t);
+    selftest_count = 0;
+    uint32_t start = ticks;
+    timer_add(&t, start + 1);
+
+    z_printf("timer wheel: re-arm at +%u ticks from callback... ", TVR_SIZE);
+    __asm__ volatile("cli");
+    while (selftest_count < 2 && ticks - start < TVR_SIZE + 10) timer_idle();
+    __asm__ volatile("sti");
+    timer_del(&t);
+
+    int ok = selftest_count == 2 && selftest_fired[1] - selftest_fired[0] == TVR_SIZE;
+    if (ok) z_printf("OK\n");
+    else z_printf("FAIL (fired %u times, gap %u ticks)\n", selftest_count,
+                  selftest_count >= 2 ? selftest_fired[1] - selftest_fired[0] : 0);
+    return ok ? 0 : -1;
+}
+
+static uint8_t cmos_read(uint8_t reg) {
+    outb(CMOS_ADDR, reg);
+    return inb(CMOS_DATA);
+}
+
+static uint32_t bcd(uint8_t v, int binary) {
+    return binary ? v : (v & 0x0F) + (v >> 4) * 10;
+}
+
+// 1970-01-01'den beri gün sayısı (proleptic Gregorian)
+static uint32_t days_from_civil(uint32_t y, uint32_t m, uint32_t d) {
+    if (m <= 2) y--;
+    uint32_t era = y / 400;
+    uint32_t yoe = y - era * 400;
+    uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// RTC'yi oku: update sürerken bekle, iki okuma tutana kadar tekrarla
+static uint32_t rtc_read_epoch() {
+    uint8_t now[6], last[6];
+    static const uint8_t regs[6] = { 0x00, 0x02, 0x04, 0x07, 0x08, 0x09 };
+    int tries = 0;
+    do {
+        for (int i = 0; i < 6; i++) last[i] = now[i];
+        while (cmos_read(0x0A) & 0x80) {}
+        for (int i = 0; i < 6; i++) now[i] = cmos_read(regs[i]);
+    } while ((!tries++ || now[0] != last[0] || now[1] != last[1] || now[2] != last[2]) && tries < 8);
+
+    uint8_t status_b = cmos_read(0x0B);
+    int binary = status_b & 0x04;
+    uint32_t sec = bcd(now[0], binary);
+    uint32_t min = bcd(now[1], binary);
+    uint32_t hour = bcd(now[2] & 0x7F, binary);
+    uint32_t day = bcd(now[3], binary);
+    uint32_t month = bcd(now[4], binary);
+    uint32_t year = bcd(now[5], binary) + 2000;
+    // 12 saat modunda bit 7 PM
+    if (!(status_b & 0x02) && (now[2] & 0x80)) hour = (hour % 12) + 12;
+    if (!month || month > 12 || !day || day > 31) return 0;
+    return days_from_civil(year, month, day) * 86400 + hour * 3600 + min * 60 + sec;
+}
+
+// Kanal 0, lobyte/hibyte, mode 2 (rate generator)
+static void pit_periodic() {
+    outb(PIT_CMD, 0x34);
+    outb(PIT_CH0, PIT_DIVISOR & 0xFF);
+    outb(PIT_CH0, PIT_DIVISOR >> 8);
+}
+
+// Kanal 0, lobyte/hibyte, mode 0 (sayım bitince OUT yükselir, IRQ0 bir kere)
+static void pit_oneshot(uint32_t counts) {
+    outb(PIT_CMD, 0x30);
+    outb(PIT_CH0, counts & 0xFF);
+    outb(PIT_CH0, counts >> 8);
+}
+
+// Read-back: kanal 0'ın sayacı ve status'u (bit 7 OUT pini) beraber latch'lenir
+static uint32_t pit_read(int* out) {
+    outb(PIT_CMD, 0xC2);
+    uint8_t status = inb(PIT_CH0);
+    uint32_t lo = inb(PIT_CH0);
+    uint32_t hi = inb(PIT_CH0);
+    if (out) *out = status & 0x80;
+    return lo | (hi << 8);
+}
+
+// IRQ0 PIC'te bekliyor mu (IRR)
+static int pit_irq_pending() {
+    outb(PIC1_COMMAND, 0x0A);
+    return inb(PIC1_COMMAND) & 0x01;
+}
+
+// Saati counts PIT sayımı kadar ilerlet
+static void timer_advance(uint32_t counts) {
+    tick_counts += counts;
+    while (tick_counts >= PIT_DIVISOR) {
+        tick_counts -= PIT_DIVISOR;
+        ticks++;
+        mono_nsec += TIMER_TICK_NSEC;
+        if (mono_nsec >= 1000000000) {
+            mono_nsec -= 1000000000;
+            mono_sec++;
+        }
+        wheel_run();
+    }
+    vdso_update_clock(ticks, mono_sec, mono_nsec, boot_epoch + mono_sec);
+}
+
+// One-shot'tan periyodik moda dön. Sayım bittiyse (OUT yüksek) sayaç
+// 0xFFFF'ten saymaya devam etmiştir, o kısım da eklenir.
+static void timer_leave_oneshot() {
+    int out;
+    uint32_t left = pit_read(&out);
+    uint32_t elapsed = out ? oneshot_counts + ((0x10000 - left) & 0xFFFF) : oneshot_counts - left;
+    pit_periodic();
+    oneshot = 0;
+    timer_advance(elapsed);
+}
+
+void timer_init() {
+    boot_epoch = rtc_read_epoch();
+    timer_tsc_khz();
+
+    pit_periodic();
+    vdso_update_clock(0, 0, 0, boot_epoch);
+
+    // PIC'te IRQ0'ı aç
+    outb(0x21, inb(0x21) & ~0x01);
+}
+
+// irq_handler'dan, interrupt'lar kapalıyken
+void timer_irq() {
+    if (oneshot) {
+        timer_leave_oneshot();
+        return;
+    }
+    timer_advance(PIT_DIVISOR);
+}
+
+// CPU'yu bir sonraki interrupt'a kadar durdur. Interrupt'lar kapalı
+// çağrılır ve kapalı döner: çağıran uyanma koşulunu (boş kuyruk, tuş yok)
+// cli altında kontrol eder, sti'nin gölgesi hlt'den önce gelen interrupt'ı
+// kaçırmaz. Periyodik tick yerine sıradaki timer'a kadar one-shot kurulur
+// (16 bit sayaçla en fazla ~55ms); başka bir IRQ uyandırırsa da periyodik
+// moda dönülür.
+void timer_idle() {
+    if (!oneshot && !pit_irq_pending()) {
+        // Mode 2 sayacı PIT_DIVISOR'dan 1'e iner: bu tick'in geçen kısmı.
+        // Periyod baştan başlatılır, bu kısım iki kere sayılmasın.
+        uint32_t before = ticks;
+        timer_advance(PIT_DIVISOR - pit_read(0));
+        if (ticks != before) {
+            // Arada timer'lar çalıştı, çağıran koşuluna tekrar baksın
+            pit_periodic();
+            return;
+        }
+        uint32_t max_ticks = TIMER_ONESHOT_MAX / PIT_DIVISOR + 1;
+        uint32_t counts = wheel_next_expiry(max_ticks) * PIT_DIVISOR - tick_counts;
+        oneshot_counts = counts < TIMER_ONESHOT_MAX ? counts : TIMER_ONESHOT_MAX;
+        pit_oneshot(oneshot_counts);
+        oneshot = 1;
+    }
+    __asm__ volatile("sti; hlt; cli" ::: "memory");
+    if (oneshot) timer_leave_oneshot();
+}
+
+uint32_t timer_ticks() {
+    return ticks;
+}
+
+// --- Meşgul bekleme: TSC ile ölçülür, interrupt'lar kapalıyken de işler ---
+//
+// Donanım beklemeleri (ATA status'u gibi) iterasyon sayısı yerine bunları
+// kullanır; süre CPU hızıyla değişmez.
+
+// TSC frekansı (kHz): PIT kanal 2 ile 10ms sayılır
+uint32_t timer_tsc_khz() {
+    static uint32_t khz = 0;
+    if (khz) return khz;
+    uint32_t latch = PIT_BASE_HZ / 100;
+    outb(0x61, (inb(0x61) & ~0x02) | 0x01);    // Gate açık, hoparlör kapalı
+    outb(PIT_CMD, 0xB0);                        // Kanal 2, lobyte/hibyte, mode 0
+    outb(0x42, latch & 0xFF);
+    outb(0x42, latch >> 8);
+    uint64_t start = rdtsc();
+    while (!(inb(0x61) & 0x20)) {}
+    khz = (uint32_t)(rdtsc() - start) / 10;
+    if (!khz) khz = 1;
+    return khz;
+}
+
+uint64_t timer_deadline_us(uint32_t us) {
+    uint32_t mhz = timer_tsc_khz() / 1000;
+    return rdtsc() + (uint64_t)us * (mhz ? mhz : 1);
+}
+
+int timer_expired(uint64_t deadline) {
+    return (long long)(rdtsc() - deadline) >= 0;
+}
+
+void timer_udelay(uint32_t us) {
+    uint64_t deadline = timer_deadline_us(us);
+    while (!timer_expired(deadline)) __asm__ volatile("pause");
+}
+
+// Tick'ler arası tutarlı okuma için interrupt'lar kısa süre kapatılır
+static uint32_t irq_save() {
+    uint32_t flags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(flags) :: "memory");
+    return flags;
+}
+
+static void irq_restore(uint32_t flags) {
+    if (flags & 0x200) __asm__ volatile("sti" ::: "memory");
+}
+
+void timer_get_monotonic(uint32_t* sec, uint32_t* nsec) {
+    uint32_t flags = irq_save();
+    *sec = mono_sec;
+    *nsec = mono_nsec;
+    irq_restore(flags);
+}
+
+void timer_get_realtime(uint32_t* sec, uint32_t* nsec) {
+    uint32_t flags = irq_save();
+    *sec = boot_epoch + mono_sec;
+    *nsec = mono_nsec;
+    irq_restore(flags);
+}
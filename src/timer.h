@@ -0,0 +1,54 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+// Kendi typedef'lerimiz
+typedef unsigned char uint8_t;
+typedef unsigned short uint16_t;
+typedef unsigned int uint32_t;
+typedef unsigned long long uint64_t;
+
+// PIT kanal 0, IRQ0
+#define TIMER_HZ        100
+#define PIT_BASE_HZ     1193182
+#define PIT_DIVISOR     ((PIT_BASE_HZ + TIMER_HZ / 2) / TIMER_HZ)
+#define TIMER_TICK_NSEC 10000151    // PIT_DIVISOR * 1e9 / PIT_BASE_HZ
+#define TIMER_ONESHOT_MAX 0xFFFF    // Boştayken tek seferde en fazla ~55ms
+#define TIMER_MS_PER_TICK (1000 / TIMER_HZ)
+#define TIMER_MS_TO_TICKS(ms) (((ms) + TIMER_MS_PER_TICK - 1) / TIMER_MS_PER_TICK)
+
+// Timer wheel'e kurulan timer; süresi dolunca fn(arg) timer interrupt'ından
+// çağrılır. Kurulu değilken pprev 0.
+struct ktimer {
+    uint32_t expires;           // Mutlak tick
+    void (*fn)(void* arg);
+    void* arg;
+    struct ktimer* next;
+    struct ktimer** pprev;
+};
+
+// Timer fonksiyonları
+void timer_init();
+void timer_irq();
+void timer_idle();
+void timer_setup(struct ktimer* t, void (*fn)(void* arg), void* arg);
+void timer_add(struct ktimer* t, uint32_t expires);
+int timer_del(struct ktimer* t);
+int timer_selftest();
+
+// Time stamp counter; benchmark'lar da farkları bununla ölçer
+static inline uint64_t rdtsc() {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// Meşgul bekleme (TSC): interrupt'lar kapalıyken de işler
+uint32_t timer_tsc_khz();
+uint64_t timer_deadline_us(uint32_t us);
+int timer_expired(uint64_t deadline);
+void timer_udelay(uint32_t us);
+uint32_t timer_ticks();
+void timer_get_monotonic(uint32_t* sec, uint32_t* nsec);
+void timer_get_realtime(uint32_t* sec, uint32_t* nsec);
+
+#endif
@@ -0,0 +1,58 @@
+#include "vdso.h"
+#include "paging.h"
+#include "pmm.h"
+#include "vm.h"
+#include "timer.h"
+#include "z_utils.h"
+
+// vdso.so'nun gömülü kopyası (vdso_image.asm)
+extern uint8_t vdso_image_start[];
+extern uint8_t vdso_image_end[];
+
+// İki frame bütün process'lerde ortak, PTE_BORROWED ile eşlenir: fork
+// kopyalamaz, mm_destroy boşaltmaz
+static uint32_t data_frame = 0;
+static uint32_t text_frame = 0;
+static struct vdso_data* data = 0;
+
+int vdso_init() {
+    uint32_t size = (uint32_t)(vdso_image_end - vdso_image_start);
+    if (size > PAGE_SIZE) return -1;
+
+    data_frame = pmm_alloc_pages_zeroed(1);
+    text_frame = pmm_alloc_pages_zeroed(1);
+    if (!data_frame || !text_frame) return -1;
+    z_memcpy(P2V(text_frame), vdso_image_start, size);
+    data = (struct vdso_data*)P2V(data_frame);
+    data->hz = TIMER_HZ;
+    return 0;
+}
+
+// Program başlarken çağrılır; fork'lanan process'ler eşlemeyi page table
+// kopyasıyla alır
+int vdso_map(struct mm* mm) {
+    if (!data) return 0;  // vDSO yoksa program syscall'larla yine çalışır
+    if (paging_map(mm->pd, VDSO_DATA_ADDR, data_frame, PTE_USER | PTE_BORROWED) < 0 ||
+        paging_map(mm->pd, VDSO_TEXT_ADDR, text_frame, PTE_USER | PTE_BORROWED) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Timer interrupt'ından, interrupt'lar kapalıyken
+void vdso_update_clock(uint32_t ticks, uint32_t mono_sec, uint32_t mono_nsec, uint32_t real_sec) {
+    if (!data) return;
+    data->seq++;
+    __asm__ volatile("" ::: "memory");
+    data->ticks = ticks;
+    data->mono_sec = mono_sec;
+    data->mono_nsec = mono_nsec;
+    data->real_sec = real_sec;
+    data->real_nsec = mono_nsec;
+    __asm__ volatile("" ::: "memory");
+    data->seq++;
+}
+
+void vdso_set_pid(uint32_t pid) {
+    if (data) data->pid = pid;
+}
@@ -0,0 +1,40 @@
+#ifndef VDSO_H
+#define VDSO_H
+
+// Kendi typedef'lerimiz
+typedef unsigned char uint8_t;
+typedef unsigned short uint16_t;
+typedef unsigned int uint32_t;
+
+#include "paging.h"
+
+// Her process'e read-only eşlenen iki sayfa (paging.h'deki VDSO_BASE):
+//   VDSO_DATA_ADDR  timer interrupt'ının güncellediği saat ve o an çalışan pid
+//   VDSO_TEXT_ADDR  vdso.so (vdso_user.c): __vdso_clock_gettime, __vdso_time,
+//                   __vdso_gettimeofday, __vdso_getpid. AT_SYSINFO_EHDR ile verilir.
+// Bu sorgular int 0x80'e hiç girmeden user'da cevaplanır.
+#define VDSO_DATA_ADDR  VDSO_BASE
+#define VDSO_TEXT_ADDR  (VDSO_BASE + 0x1000)
+
+// Kernel yazarken seq tek, bitince çift olur; okuyucu seq değişmişse tekrar
+// okur (seqlock). Tek CPU'da yazan IRQ handler'ı user'ı kesip bitirdiği için
+// okuyucu tek seq'i hiç görmez ama ileride SMP'de de doğru kalır.
+struct vdso_data {
+    volatile uint32_t seq;
+    uint32_t hz;                // Timer frekansı
+    uint32_t ticks;             // Boot'tan beri timer tick'i
+    uint32_t mono_sec;          // CLOCK_MONOTONIC
+    uint32_t mono_nsec;
+    uint32_t real_sec;          // CLOCK_REALTIME (RTC'den, boot'ta okunur)
+    uint32_t real_nsec;
+    uint32_t pid;               // current_process'in pid'i
+};
+
+// Kernel tarafı (vdso.c)
+struct mm;
+int vdso_init();
+int vdso_map(struct mm* mm);
+void vdso_update_clock(uint32_t ticks, uint32_t mono_sec, uint32_t mono_nsec, uint32_t real_sec);
+void vdso_set_pid(uint32_t pid);
+
+#endif
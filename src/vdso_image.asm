@@ -0,0 +1,7 @@
+; vdso.so'yu kernel image'ına göm; vdso_init buradan sayfaya kopyalar
+section .rodata
+global vdso_image_start, vdso_image_end
+
+vdso_image_start:
+    incbin "vdso.so"
+vdso_image_end:
@@ -0,0 +1,77 @@
+// vDSO: kernel'e gömülüp her process'e VDSO_TEXT_ADDR'de eşlenen küçük
+// shared object. -fPIC derlenir, relocation'ı yok; veri sayfası sabit
+// adreste (VDSO_DATA_ADDR). Bilinmeyen clock'lar için int 0x80'e düşer.
+#include "vdso.h"
+#include "syscall.h"  // Syscall ve CLOCK_* numaraları
+
+struct vdso_timespec {
+    long tv_sec;
+    long tv_nsec;
+};
+
+struct vdso_timeval {
+    long tv_sec;
+    long tv_usec;
+};
+
+#define vd ((const volatile struct vdso_data*)VDSO_DATA_ADDR)
+
+static inline long vdso_syscall2(long nr, long a, long b) {
+    long ret;
+    __asm__ volatile("int $0x80" : "=a"(ret) : "a"(nr), "b"(a), "c"(b) : "memory");
+    return ret;
+}
+
+// Seqlock: kernel tam o sırada yazdıysa tekrar oku
+static void read_clock(int real, uint32_t* sec, uint32_t* nsec) {
+    uint32_t seq;
+    do {
+        while ((seq = vd->seq) & 1) {}
+        __asm__ volatile("" ::: "memory");
+        *sec = real ? vd->real_sec : vd->mono_sec;
+        *nsec = real ? vd->real_nsec : vd->mono_nsec;
+        __asm__ volatile("" ::: "memory");
+    } while (vd->seq != seq);
+}
+
+int __vdso_clock_gettime(int clock, struct vdso_timespec* ts) {
+    uint32_t sec, nsec;
+    switch (clock) {
+        case CLOCK_REALTIME:
+        case CLOCK_REALTIME_COARSE:
+            read_clock(1, &sec, &nsec);
+            break;
+        case CLOCK_MONOTONIC:
+        case CLOCK_MONOTONIC_RAW:
+        case CLOCK_MONOTONIC_COARSE:
+        case CLOCK_BOOTTIME:
+            read_clock(0, &sec, &nsec);
+            break;
+        default:
+            return (int)vdso_syscall2(SYS_CLOCK_GETTIME, clock, (long)ts);
+    }
+    ts->tv_sec = (long)sec;
+    ts->tv_nsec = (long)nsec;
+    return 0;
+}
+
+int __vdso_gettimeofday(struct vdso_timeval* tv, void* tz) {
+    if (tz) return (int)vdso_syscall2(SYS_GETTIMEOFDAY, (long)tv, (long)tz);
+    if (tv) {
+        uint32_t sec, nsec;
+        read_clock(1, &sec, &nsec);
+        tv->tv_sec = (long)sec;
+        tv->tv_usec = (long)(nsec / 1000);
+    }
+    return 0;
+}
+
+long __vdso_time(long* t) {
+    long sec = (long)vd->real_sec;
+    if (t) *t = sec;
+    return sec;
+}
+
+int __vdso_getpid() {
+    return (int)vd->pid;
+}
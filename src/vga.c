@@ -1,4 +1,7 @@
 #include "vga.h"
+#include "paging.h"
+#include "z_utils.h"
+#include "timer.h"
 
 // VESA framebuffer variables - will be set by boot.asm
 extern uint32_t* framebuffer;
@@ -9,6 +12,7 @@ extern uint32_t fb_pitch;
 // Cursor position
 static int cursor_x = 0;
 static int cursor_y = 0;
+static uint32_t scroll_count = 0;   // Ekran kaydıkça ya da temizlendikçe artar
 
 // VGA color palette for 32-bit BGRA (common VESA format)
 static uint32_t vga_colors[16] = {
@@ -301,6 +305,16 @@ static uint8_t reverse_bits(uint8_t b) {
     return b;
 }
 
+// Framebuffer write-combining eşlendiğinde (paging_init) ardışık store'lar
+// burst'e birleşir; bu yüzden satırlar rep stosl/movsl ile soldan sağa yazılır.
+static inline void fill32(uint32_t* dst, uint32_t value, uint32_t count) {
+    __asm__ volatile("rep stosl" : "+D"(dst), "+c"(count) : "a"(value) : "memory");
+}
+
+static inline void copy32(uint32_t* dst, const uint32_t* src, uint32_t count) {
+    __asm__ volatile("rep movsl" : "+D"(dst), "+S"(src), "+c"(count) : : "memory");
+}
+
 // Draw a single pixel at (x, y) with color
 static void draw_pixel(int x, int y, uint32_t color) {
     if (x < 0 || x >= (int)fb_width || y < 0 || y >= (int)fb_height || !framebuffer)
@@ -323,6 +337,23 @@ static void draw_char(int x, int y, char c, uint8_t fg_color, uint8_t bg_color)
     
     uint8_t* glyph = font_8x8[char_index];
     
+    // Hücre tamamen ekrandaysa her satır 8 ardışık piksel olarak yazılır
+    if (x >= 0 && y >= 0 && x + 8 <= (int)fb_width && y + 16 <= (int)fb_height) {
+        uint32_t* dst = framebuffer + y * (fb_pitch / 4) + x;
+        uint32_t pixels[8];
+        for (int row = 0; row < 8; row++) {
+            uint8_t line = reverse_bits(glyph[row]);
+            for (int col = 0; col < 8; col++) {
+                pixels[col] = (line & (0x80 >> col)) ? fg : bg;
+            }
+            copy32(dst, pixels, 8);
+            dst += fb_pitch / 4;
+            copy32(dst, pixels, 8);
+            dst += fb_pitch / 4;
+        }
+        return;
+    }
+    
     for (int row = 0; row < 8; row++) {
         uint8_t line = reverse_bits(glyph[row]); // FIXED: Now using reverse_bits!
         for (int col = 0; col < 8; col++) {
@@ -345,36 +376,34 @@ void vga_init(uint32_t mb_magic, uint32_t mb_addr) {
 void clear_screen() {
     if (!framebuffer) return;
     
-    // Clear framebuffer to black
-    uint32_t total_pixels = fb_width * fb_height;
-    for (uint32_t i = 0; i < total_pixels; i++) {
-        framebuffer[i] = vga_colors[VGA_COLOR_BLACK];
+    // Clear framebuffer to black (pitch genişlikten büyük olabilir)
+    for (uint32_t y = 0; y < fb_height; y++) {
+        fill32(framebuffer + y * (fb_pitch / 4), vga_colors[VGA_COLOR_BLACK], fb_width);
     }
     
     cursor_x = 0;
     cursor_y = 0;
+    scroll_count++;
 }
 
 void scroll() {
     if (!framebuffer) return;
+    scroll_count++;
     
     // Move framebuffer content up by 16 pixels (1 character row height)
     uint32_t* src = framebuffer + (fb_pitch / 4) * 16;
     uint32_t* dst = framebuffer;
     uint32_t lines_to_copy = fb_height - 16;
     
+    // dst < src, ileri doğru kopyalama üst üste binmede güvenli
     for (uint32_t y = 0; y < lines_to_copy; y++) {
-        for (uint32_t x = 0; x < fb_width; x++) {
-            dst[y * (fb_pitch / 4) + x] = src[y * (fb_pitch / 4) + x];
-        }
+        copy32(dst + y * (fb_pitch / 4), src + y * (fb_pitch / 4), fb_width);
     }
     
     // Clear the last 16 pixel rows
     uint32_t* last_line = framebuffer + (fb_height - 16) * (fb_pitch / 4);
     for (int y = 0; y < 16; y++) {
-        for (uint32_t x = 0; x < fb_width; x++) {
-            last_line[y * (fb_pitch / 4) + x] = vga_colors[VGA_COLOR_BLACK];
-        }
+        fill32(last_line + y * (fb_pitch / 4), vga_colors[VGA_COLOR_BLACK], fb_width);
     }
 }
 
@@ -391,6 +420,23 @@ int get_cursor_y() {
     return cursor_y;
 }
 
+// Sabit bir yere çizen (banner gibi) kod, altındaki metin kaydı mı diye bakar
+uint32_t get_scroll_count() {
+    return scroll_count;
+}
+
+// [y, y+height) piksel satırlarını siyaha boya
+void vga_clear_rows(int y, int height) {
+    if (!framebuffer) return;
+    if (y < 0) {
+        height += y;
+        y = 0;
+    }
+    for (int row = y; row < y + height && row < (int)fb_height; row++) {
+        fill32(framebuffer + row * (fb_pitch / 4), vga_colors[VGA_COLOR_BLACK], fb_width);
+    }
+}
+
 void putchar_color(char c, uint8_t color) {
     if (!framebuffer) return;
     
@@ -466,15 +512,51 @@ void vga_draw_bitmap(int x, int y, uint32_t width, uint32_t height, uint32_t* pi
         uint32_t* src_row = pixels + src_y * width;
         uint32_t* dst_row = framebuffer + py * (fb_pitch / 4);
         
-        for (int px = x_start; px < x_end; px++) {
-            int src_x = px - x;
-            uint32_t pixel_color = src_row[src_x];
-            
-            // Check if pixel is transparent (alpha < 128)
-            uint8_t alpha = (pixel_color >> 24) & 0xFF;
-            if (alpha >= 128) {
-                dst_row[px] = pixel_color;
-            }
+        // Opak piksel dizileri tek seferde kopyalanır; transparent
+        // (alpha < 128) pikseller atlanır
+        int px = x_start;
+        while (px < x_end) {
+            while (px < x_end && (src_row[px - x] >> 24) < 128) px++;
+            int run = px;
+            while (px < x_end && (src_row[px - x] >> 24) >= 128) px++;
+            if (px > run) copy32(dst_row + run, src_row + (run - x), px - run);
+        }
+    }
+}
+
+// --- Framebuffer fill benchmark: aynı doldurma UC ve WC eşlemeyle ---
+
+// Ekranı rounds kez doldur, MB/s döner (byte/us)
+static uint32_t fill_rate(uint32_t rounds) {
+    uint32_t mhz = timer_tsc_khz() / 1000;
+    if (!mhz) mhz = 1;
+    uint32_t us = 0;
+    for (uint32_t i = 0; i < rounds; i++) {
+        uint32_t color = vga_colors[i & 0x0F];
+        uint64_t start = rdtsc();
+        for (uint32_t y = 0; y < fb_height; y++) {
+            fill32(framebuffer + y * (fb_pitch / 4), color, fb_width);
         }
+        us += (uint32_t)(rdtsc() - start) / mhz;
     }
+    if (!us) us = 1;
+    return fb_width * 4 * fb_height * rounds / us;
+}
+
+void vga_fill_benchmark(uint32_t rounds) {
+    if (!framebuffer) return;
+    if (!rounds) rounds = 16;
+    if (rounds > 256) rounds = 256;
+
+    paging_fb_set_write_combining(0);
+    uint32_t uc = fill_rate(rounds);
+    paging_fb_set_write_combining(1);
+    uint32_t wc = fill_rate(rounds);
+    clear_screen();
+
+    static const char* modes[] = { "none (firmware default)", "PAT", "MTRR" };
+    z_printf("Framebuffer fill: %ux%u, %u rounds (TSC %u MHz)\n", fb_width, fb_height, rounds, timer_tsc_khz() / 1000);
+    z_printf("  write-combining via %s\n", modes[paging_fb_cache_mode()]);
+    z_printf("  uncached:        %u MB/s\n", uc);
+    z_printf("  write-combining: %u MB/s\n", wc);
 }
@@ -38,6 +38,9 @@ void scroll();
 void move_cursor(int x, int y);
 int get_cursor_x();
 int get_cursor_y();
+uint32_t get_scroll_count();
+void vga_clear_rows(int y, int height);
 void vga_draw_bitmap(int x, int y, uint32_t width, uint32_t height, uint32_t* pixels);
+void vga_fill_benchmark(uint32_t rounds);
 
 #endif 
\ No newline at end of file
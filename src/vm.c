@@ -0,0 +1,453 @@
+#include "vm.h"
+#include "paging.h"
+#include "memory.h"
+#include "z_utils.h"
+#include "pagecache.h"
+
+// Process address space'leri ve demand paging. Dosya arkalı aralıklar
+// (ELF PT_LOAD'ları) kaydedilir ama sayfa ayrılmaz; ilk erişimdeki page
+// fault sayfayı ramdisk'teki ISO kopyasından doldurur. Read-only, tamamı
+// dosyadan gelen ve ramdisk'te sayfa hizalı duran sayfalar hiç kopyalanmadan
+// ramdisk sayfasının kendisiyle eşlenir (PTE_BORROWED).
+
+static struct mm* current_mm = 0;
+
+struct mm* mm_create() {
+    struct mm* mm = (struct mm*)kmalloc(sizeof(struct mm));
+    if (!mm) return 0;
+    mm->pd = paging_create_directory();
+    if (!mm->pd) {
+        kfree(mm);
+        return 0;
+    }
+    mm->areas = 0;
+    mm->faults = 0;
+    mm->cow_faults = 0;
+    mm->users = 1;
+    mm->start_brk = 0;
+    mm->brk = 0;
+    return mm;
+}
+
+// Kullanan son process bırakınca bütün sayfalarıyla birlikte yok edilir
+void mm_destroy(struct mm* mm) {
+    if (!mm || --mm->users) return;
+    if (current_mm == mm) mm_switch(0);
+
+    struct vm_area* a = mm->areas;
+    while (a) {
+        struct vm_area* next = a->next;
+        kfree(a);
+        a = next;
+    }
+    paging_destroy_directory(mm->pd);
+    kfree(mm);
+}
+
+// mm 0 ise kernel directory'sine dönülür
+void mm_switch(struct mm* mm) {
+    current_mm = mm;
+    paging_switch(mm ? mm->pd : paging_kernel_directory());
+}
+
+struct mm* mm_current() {
+    return current_mm;
+}
+
+// Fork: area listesi kopyalanır, sayfalar copy-on-write paylaşılır
+struct mm* mm_fork(struct mm* parent) {
+    struct mm* mm = mm_create();
+    if (!mm) return 0;
+
+    struct vm_area** tail = &mm->areas;
+    for (struct vm_area* a = parent->areas; a; a = a->next) {
+        struct vm_area* copy = (struct vm_area*)kmalloc(sizeof(struct vm_area));
+        if (!copy) {
+            mm_destroy(mm);
+            return 0;
+        }
+        *copy = *a;
+        copy->next = 0;
+        *tail = copy;
+        tail = &copy->next;
+    }
+    mm->start_brk = parent->start_brk;
+    mm->brk = parent->brk;
+    if (paging_clone_user(mm->pd, parent->pd) < 0) {
+        mm_destroy(mm);
+        return 0;
+    }
+    return mm;
+}
+
+struct vm_area* mm_find_area(struct mm* mm, uint32_t addr) {
+    for (struct vm_area* a = mm->areas; a && a->start <= addr; a = a->next) {
+        if (addr < a->end) return a;
+    }
+    return 0;
+}
+
+// [start, end) herhangi bir area'ya ya da eşli sayfaya değiyor mu
+static int range_busy(struct mm* mm, uint32_t start, uint32_t end) {
+    for (struct vm_area* a = mm->areas; a; a = a->next) {
+        if (start < a->end && end > a->start) return 1;
+    }
+    for (uint32_t va = start; va < end; va += PAGE_SIZE) {
+        if (paging_lookup(mm->pd, va)) return 1;
+    }
+    return 0;
+}
+
+// PROT_NONE area'ların sayfaları user'a kapalı (sadece kernel erişir)
+static uint32_t area_pte_flags(uint32_t flags) {
+    return ((flags & VM_ACCESS) ? PTE_USER : 0) | ((flags & VM_WRITE) ? PTE_WRITE : 0);
+}
+
+// Cache'li area'nın [pos, pos+len) cihaz byte'larını dst'ye kopyala;
+// hizasız offset'te bir dosya sayfası iki cache sayfasına yayılır
+static int cache_copy(uint32_t dev, uint32_t pos, uint8_t* dst, uint32_t len) {
+    while (len) {
+        const uint8_t* src = pagecache_get(dev, pos >> PAGE_SHIFT);
+        if (!src) return -1;
+        uint32_t in_page = pos & (PAGE_SIZE - 1);
+        uint32_t n = PAGE_SIZE - in_page < len ? PAGE_SIZE - in_page : len;
+        z_memcpy(dst, src + in_page, n);
+        dst += n;
+        pos += n;
+        len -= n;
+    }
+    return 0;
+}
+
+// Area'nın page sayfasını doldurup eşle
+static int area_fill(struct mm* mm, struct vm_area* a, uint32_t page) {
+    uint32_t off = page - a->start;
+    uint32_t avail = off < a->file_size ? a->file_size - off : 0;
+    if (avail > PAGE_SIZE) avail = PAGE_SIZE;
+    uint32_t pos = a->file_offset + off;
+    const uint8_t* src = a->file_data + off;
+    uint32_t pte = area_pte_flags(a->flags);
+
+    // Değişmeyecek tam dosya sayfası: ramdisk/cache sayfasını ödünç al
+    if (!(a->flags & VM_WRITE) && avail == PAGE_SIZE) {
+        if (a->file_dev) src = (pos & (PAGE_SIZE - 1)) ? 0 : pagecache_get(a->file_dev, pos >> PAGE_SHIFT);
+        if (src && ((uint32_t)src & (PAGE_SIZE - 1)) == 0) {
+            return paging_map(mm->pd, page, V2P(src), pte | PTE_BORROWED);
+        }
+    }
+
+    uint32_t phys = avail == PAGE_SIZE ? pmm_alloc_pages(1) : pmm_alloc_pages_zeroed(1);
+    if (!phys) return -1;
+    if (avail) {
+        if (!a->file_dev) {
+            z_memcpy(P2V(phys), a->file_data + off, avail);
+        } else if (cache_copy(a->file_dev, pos, (uint8_t*)P2V(phys), avail) < 0) {
+            pmm_free_pages(phys, 1);
+            return -1;
+        }
+    }
+    if (paging_map(mm->pd, page, phys, pte) < 0) {
+        pmm_free_pages(phys, 1);
+        return -1;
+    }
+    return 0;
+}
+
+// Dosya arkalı aralığı tembel olarak kaydet. data ramdisk gibi program
+// boyunca yerinde kalan bir bellek olmalı. Aralık dolu ise -1.
+int mm_map_file(struct mm* mm, uint32_t start, uint32_t size, uint32_t flags,
+                const uint8_t* data, uint32_t data_size) {
+    uint32_t end = start + size;
+    if ((start & (PAGE_SIZE - 1)) || !size || start < USER_BASE || end > USER_TOP || end < start) {
+        return -1;
+    }
+    end = (end + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    if (range_busy(mm, start, end)) return -1;
+
+    struct vm_area* a = (struct vm_area*)kmalloc(sizeof(struct vm_area));
+    if (!a) return -1;
+    a->start = start;
+    a->end = end;
+    a->flags = flags;
+    a->file_data = data;
+    a->file_dev = PAGECACHE_DEV_NONE;
+    a->file_offset = 0;
+    a->file_size = data_size;
+
+    struct vm_area** link = &mm->areas;
+    while (*link && (*link)->start < start) link = &(*link)->next;
+    a->next = *link;
+    *link = a;
+    return 0;
+}
+
+// mm_map_file'ın page cache'li hali: dosya dev cihazında offset'ten başlar,
+// sayfalar ilk erişimde cache'ten (gerekirse cihazdan okunarak) gelir
+int mm_map_cache(struct mm* mm, uint32_t start, uint32_t size, uint32_t flags,
+                 uint32_t dev, uint32_t offset, uint32_t data_size) {
+    if (mm_map_file(mm, start, size, flags, 0, data_size) < 0) return -1;
+    struct vm_area* a = mm_find_area(mm, start);
+    a->file_dev = dev;
+    a->file_offset = offset;
+    return 0;
+}
+
+// Sayfayı şimdi hazırla: area'sı varsa ondan doldur, yoksa sıfır sayfa.
+// Ödünç alınmış ya da COW sayfa yazılacaksa önce özel kopyası çıkarılır.
+static uint32_t page_make_private(struct mm* mm, uint32_t va, uint32_t flags) {
+    uint32_t entry = paging_lookup(mm->pd, va);
+    if (!entry) {
+        struct vm_area* a = mm_find_area(mm, va);
+        if (a) {
+            if (area_fill(mm, a, va) < 0) return 0;
+        } else {
+            uint32_t phys = pmm_alloc_pages_zeroed(1);
+            if (!phys) return 0;
+            if (paging_map(mm->pd, va, phys, area_pte_flags(flags)) < 0) {
+                pmm_free_pages(phys, 1);
+                return 0;
+            }
+        }
+        entry = paging_lookup(mm->pd, va);
+    }
+    if (entry & (PTE_BORROWED | PTE_COW)) {
+        if (paging_unshare(mm->pd, va) < 0) return 0;
+        entry = paging_lookup(mm->pd, va);
+    }
+    // İki segmentin paylaştığı sayfa ikisinin de izinlerini alır
+    paging_protect(mm->pd, va, (entry & PTE_FLAGS_MASK) | area_pte_flags(flags));
+    return entry & PTE_ADDR_MASK;
+}
+
+// [vaddr, vaddr+memsz) aralığını şimdi doldur: dosya data'dan ya da dev
+// verilmişse page cache'te offset'ten okunur, filesz sonrası sıfırlanır
+static int load_range(struct mm* mm, uint32_t vaddr, uint32_t memsz, uint32_t flags,
+                      const uint8_t* data, uint32_t dev, uint32_t offset, uint32_t filesz) {
+    uint32_t end = vaddr + memsz;
+    uint32_t file_end = vaddr + filesz;
+    if (vaddr < USER_BASE || end > USER_TOP || end < vaddr || filesz > memsz) return -1;
+
+    for (uint32_t va = vaddr & ~(PAGE_SIZE - 1); va < end; va += PAGE_SIZE) {
+        uint32_t phys = page_make_private(mm, va, flags);
+        if (!phys) return -1;
+
+        uint8_t* page = (uint8_t*)P2V(phys);
+        uint32_t lo = va < vaddr ? vaddr : va;
+        uint32_t hi = end - va > PAGE_SIZE ? va + PAGE_SIZE : end;
+        uint32_t mid = file_end < lo ? lo : (file_end > hi ? hi : file_end);
+        if (mid > lo) {
+            if (!dev) z_memcpy(page + (lo - va), data + (lo - vaddr), mid - lo);
+            else if (cache_copy(dev, offset + (lo - vaddr), page + (lo - va), mid - lo) < 0) return -1;
+        }
+        if (hi > mid) z_memset(page + (mid - va), 0, hi - mid);
+    }
+    return 0;
+}
+
+// mm_map_file'ın hemen dolduran hali: data geçiciyse (heap kopyası) ya da
+// segment başka bir segmentle sayfa paylaşıyorsa kullanılır. vaddr hizasız
+// olabilir; sadece [vaddr, vaddr+memsz) yazılır, filesz sonrası sıfırlanır.
+int mm_load_file(struct mm* mm, uint32_t vaddr, uint32_t memsz, uint32_t flags,
+                 const uint8_t* data, uint32_t filesz) {
+    return load_range(mm, vaddr, memsz, flags, data, PAGECACHE_DEV_NONE, 0, filesz);
+}
+
+// mm_load_file'ın page cache'li hali: dosya dev cihazında offset'ten başlar
+int mm_load_cache(struct mm* mm, uint32_t vaddr, uint32_t memsz, uint32_t flags,
+                  uint32_t dev, uint32_t offset, uint32_t filesz) {
+    return load_range(mm, vaddr, memsz, flags, 0, dev, offset, filesz);
+}
+
+// Ne eşli sayfaya ne de henüz doldurulmamış bir area'ya değen boş aralık
+uint32_t mm_find_free(struct mm* mm, uint32_t start, uint32_t size) {
+    while ((start = paging_find_free(mm->pd, start, size)) != 0) {
+        struct vm_area* hit = 0;
+        for (struct vm_area* a = mm->areas; a; a = a->next) {
+            if (start < a->end && start + size > a->start) {
+                hit = a;
+                break;
+            }
+        }
+        if (!hit) return start;
+        start = hit->end;
+    }
+    return 0;
+}
+
+// a'yı at adresinde ikiye böl; sağ parça listede a'nın arkasına girer
+static struct vm_area* area_split(struct vm_area* a, uint32_t at) {
+    struct vm_area* right = (struct vm_area*)kmalloc(sizeof(struct vm_area));
+    if (!right) return 0;
+    uint32_t skip = at - a->start;
+    *right = *a;
+    right->start = at;
+    right->file_data = a->file_data ? a->file_data + skip : 0;
+    right->file_offset = a->file_dev ? a->file_offset + skip : 0;
+    right->file_size = a->file_size > skip ? a->file_size - skip : 0;
+    if (a->file_size > skip) a->file_size = skip;
+    a->end = at;
+    a->next = right;
+    return right;
+}
+
+// [start, end) sınırlarında area'ları böl; sonrasında her area ya tamamen
+// içeride ya tamamen dışarıda kalır
+static int areas_split_range(struct mm* mm, uint32_t start, uint32_t end) {
+    for (struct vm_area* a = mm->areas; a && a->start < end; a = a->next) {
+        if (a->start < start && start < a->end && !area_split(a, start)) return -1;
+        if (a->start < end && end < a->end && !area_split(a, end)) return -1;
+    }
+    return 0;
+}
+
+// [start, start+size) aralığındaki sayfaları bırak, area'ları kırp/böl
+int mm_unmap(struct mm* mm, uint32_t start, uint32_t size) {
+    uint32_t end = start + size;
+    if ((start & (PAGE_SIZE - 1)) || start < USER_BASE || end > USER_TOP || end < start) return -1;
+    if (areas_split_range(mm, start, end) < 0) return -1;
+
+    struct vm_area** link = &mm->areas;
+    while (*link) {
+        struct vm_area* a = *link;
+        if (a->start >= start && a->end <= end) {
+            *link = a->next;
+            kfree(a);
+            continue;
+        }
+        link = &a->next;
+    }
+    paging_free_range(mm->pd, start, size);
+    return 0;
+}
+
+// mprotect: aralıktaki area'ların izinleri değişir, eşli sayfalar da güncellenir.
+// Yazma izni paylaşılan sayfalarda COW olarak verilir (paging_protect).
+int mm_protect(struct mm* mm, uint32_t start, uint32_t size, uint32_t flags) {
+    uint32_t end = start + size;
+    if ((start & (PAGE_SIZE - 1)) || start < USER_BASE || end > USER_TOP || end < start) return -1;
+    if (areas_split_range(mm, start, end) < 0) return -1;
+
+    for (struct vm_area* a = mm->areas; a && a->start < end; a = a->next) {
+        if (a->start >= start) a->flags = flags | (a->flags & VM_GROWSDOWN);
+    }
+    for (uint32_t va = start; va < end; va += PAGE_SIZE) {
+        if (paging_lookup(mm->pd, va)) paging_protect(mm->pd, va, area_pte_flags(flags));
+    }
+    return 0;
+}
+
+// mmap için yer: fixed değilse addr sadece ipucu, boşsa kullanılır; değilse
+// USER_MMAP_BASE'den yer aranır. fixed'de aralıktaki eski eşlemeler
+// kaldırılır. size sayfa hizalı olmalı. Başarısızlıkta 0.
+uint32_t mm_get_unmapped_area(struct mm* mm, uint32_t addr, uint32_t size, int fixed) {
+    if (!size) return 0;
+    if (fixed) return mm_unmap(mm, addr, size) < 0 ? 0 : addr;
+    addr &= ~(PAGE_SIZE - 1);
+    if (addr < USER_BASE || mm_find_free(mm, addr, size) != addr) {
+        addr = mm_find_free(mm, USER_MMAP_BASE, size);
+    }
+    return addr;
+}
+
+// mmap: size byte'lık yeni area (yeri mm_get_unmapped_area seçer). data 0
+// ise anonim (sıfır dolu) eşleme. Sayfalar ilk erişimde doldurulur.
+// Başarısızlıkta 0.
+uint32_t mm_mmap(struct mm* mm, uint32_t addr, uint32_t size, uint32_t flags, int fixed,
+                 const uint8_t* data, uint32_t data_size) {
+    size = (size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    addr = mm_get_unmapped_area(mm, addr, size, fixed);
+    if (!addr) return 0;
+    if (mm_map_file(mm, addr, size, flags, data, data ? data_size : 0) < 0) return 0;
+    return addr;
+}
+
+// --- User stack ---
+//
+// Stack USER_STACK_TOP'ta tek sayfalık VM_GROWSDOWN area olarak başlar.
+// Altına dokunuldukça area o sayfaya kadar uzar (sayfalar yine ilk
+// dokunuşta sıfır olarak gelir); area'nın boyu böylece stack'in en derin
+// kullanımını da gösterir. En fazla USER_STACK_SIZE - 1 sayfa: en alttaki
+// sayfa guard, oraya inen program page fault ile biter.
+
+#define USER_STACK_LIMIT (USER_STACK_TOP - USER_STACK_SIZE + PAGE_SIZE)
+
+int mm_map_stack(struct mm* mm) {
+    return mm_map_file(mm, USER_STACK_TOP - PAGE_SIZE, PAGE_SIZE,
+                       VM_READ | VM_WRITE | VM_GROWSDOWN, 0, 0);
+}
+
+// addr'ın hemen üstündeki area stack ise onu addr'ın sayfasına kadar uzat.
+// Alttaki area'yla arada en az bir boş sayfa kalmalı.
+static struct vm_area* stack_grow(struct mm* mm, uint32_t addr) {
+    uint32_t page = addr & ~(PAGE_SIZE - 1);
+    if (page < USER_STACK_LIMIT) return 0;
+
+    struct vm_area* below = 0;
+    struct vm_area* a = mm->areas;
+    while (a && a->end <= addr) {
+        below = a;
+        a = a->next;
+    }
+    if (!a || !(a->flags & VM_GROWSDOWN)) return 0;
+    if (below && below->end + PAGE_SIZE > page) return 0;
+    a->start = page;
+    return a;
+}
+
+uint32_t mm_stack_size(struct mm* mm) {
+    struct vm_area* a = mm_find_area(mm, USER_STACK_TOP - 1);
+    return a && (a->flags & VM_GROWSDOWN) ? a->end - a->start : 0;
+}
+
+// Heap programın son PT_LOAD segmentinin hemen arkasından başlar
+void mm_set_brk(struct mm* mm, uint32_t start) {
+    mm->start_brk = (start + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    mm->brk = mm->start_brk;
+}
+
+// brk(): heap sayfa sayfa büyür/küçülür. Büyürken yeni sayfalar anonim
+// area olarak eklenir (ilk dokunuşta sıfır sayfa), küçülürken boşta kalan
+// sayfalar bırakılır. Linux gibi başarısızlıkta eski break döner.
+uint32_t mm_brk(struct mm* mm, uint32_t brk) {
+    if (!mm->start_brk || brk < mm->start_brk || brk > USER_TOP) return mm->brk;
+
+    uint32_t old_end = (mm->brk + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    uint32_t new_end = (brk + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    if (new_end > old_end) {
+        if (range_busy(mm, old_end, new_end)) return mm->brk;
+        // Heap'in son area'sı hemen arkadaysa onu uzat, yoksa yeni area
+        struct vm_area* last = old_end > mm->start_brk ? mm_find_area(mm, old_end - 1) : 0;
+        if (last && last->end == old_end && !last->file_data && !last->file_dev && last->flags == (VM_READ | VM_WRITE)) {
+            last->end = new_end;
+        } else if (mm_map_file(mm, old_end, new_end - old_end, VM_READ | VM_WRITE, 0, 0) < 0) {
+            return mm->brk;
+        }
+    } else if (new_end < old_end) {
+        mm_unmap(mm, new_end, old_end - new_end);
+    }
+    mm->brk = brk;
+    return brk;
+}
+
+int vm_fault(uint32_t addr, uint32_t err) {
+    struct mm* mm = current_mm;
+    if (!mm || addr < USER_BASE || addr >= USER_TOP) return 0;
+
+    // Koruma ihlali sadece COW sayfaya yazmaysa çözülür (kernel'in
+    // copy-to-user yazmaları da CR0.WP sayesinde buraya düşer)
+    if (err & PF_PRESENT) {
+        uint32_t entry = paging_lookup(mm->pd, addr);
+        if (!(err & PF_WRITE) || !(entry & PTE_COW)) return 0;
+        if (paging_unshare(mm->pd, addr & ~(PAGE_SIZE - 1)) < 0) return 0;
+        mm->cow_faults++;
+        return 1;
+    }
+
+    struct vm_area* a = mm_find_area(mm, addr);
+    if (!a) a = stack_grow(mm, addr);
+    if (!a || !(a->flags & VM_ACCESS)) return 0;
+    if ((err & PF_WRITE) && !(a->flags & VM_WRITE)) return 0;
+    if (area_fill(mm, a, addr & ~(PAGE_SIZE - 1)) < 0) return 0;
+    mm->faults++;
+    return 1;
+}
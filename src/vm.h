@@ -0,0 +1,73 @@
+#ifndef VM_H
+#define VM_H
+
+// Kendi typedef'lerimiz
+typedef unsigned char uint8_t;
+typedef unsigned short uint16_t;
+typedef unsigned int uint32_t;
+
+// vm_area izinleri (PROT_* ile aynı değerler)
+#define VM_NONE     0x0
+#define VM_READ     0x1
+#define VM_WRITE    0x2
+#define VM_EXEC     0x4
+#define VM_ACCESS   (VM_READ | VM_WRITE | VM_EXEC)
+#define VM_GROWSDOWN 0x100      // Stack: hemen altına dokunulunca aşağı uzar
+
+// Process address space'inde mmap/ELF ile kurulmuş bir aralık (VMA).
+// Sayfalar ilk dokunuşta page fault ile file_data'dan (ramdisk) ya da
+// file_dev'in page cache'inden doldurulur, file_size'ı aşan kısım sıfır
+// okunur (.bss); anonim area'larda ikisi de 0.
+struct vm_area {
+    uint32_t start;             // Sayfa hizalı
+    uint32_t end;
+    uint32_t flags;             // VM_*
+    const uint8_t* file_data;   // start'a karşılık gelen dosya byte'ları
+    uint32_t file_dev;          // PAGECACHE_DEV_*; 0 ise file_data kullanılır
+    uint32_t file_offset;       // file_dev'de start'a karşılık gelen byte
+    uint32_t file_size;         // start'tan itibaren dosyadan gelen byte sayısı
+    struct vm_area* next;       // start'a göre sıralı
+};
+
+// Process address space'i
+struct mm {
+    uint32_t* pd;
+    struct vm_area* areas;
+    uint32_t faults;            // Demand paging ile doldurulan sayfa sayısı
+    uint32_t cow_faults;        // Yazılınca kopyalanan (ya da sahiplenilen) COW sayfaları
+    uint32_t users;             // mm'i paylaşan process sayısı (vfork, CLONE_VM)
+    uint32_t start_brk;         // Heap'in başı: programın son segmentinin sonu (sayfa hizalı)
+    uint32_t brk;               // Şu anki program break (byte granül)
+};
+
+// Address space fonksiyonları
+struct mm* mm_create();
+void mm_destroy(struct mm* mm);
+void mm_switch(struct mm* mm);
+struct mm* mm_current();
+struct mm* mm_fork(struct mm* parent);
+
+int mm_map_file(struct mm* mm, uint32_t start, uint32_t size, uint32_t flags,
+                const uint8_t* data, uint32_t data_size);
+int mm_map_cache(struct mm* mm, uint32_t start, uint32_t size, uint32_t flags,
+                 uint32_t dev, uint32_t offset, uint32_t data_size);
+int mm_load_file(struct mm* mm, uint32_t vaddr, uint32_t memsz, uint32_t flags,
+                 const uint8_t* data, uint32_t filesz);
+int mm_load_cache(struct mm* mm, uint32_t vaddr, uint32_t memsz, uint32_t flags,
+                  uint32_t dev, uint32_t offset, uint32_t filesz);
+struct vm_area* mm_find_area(struct mm* mm, uint32_t addr);
+uint32_t mm_find_free(struct mm* mm, uint32_t start, uint32_t size);
+uint32_t mm_get_unmapped_area(struct mm* mm, uint32_t addr, uint32_t size, int fixed);
+uint32_t mm_mmap(struct mm* mm, uint32_t addr, uint32_t size, uint32_t flags, int fixed,
+                 const uint8_t* data, uint32_t data_size);
+int mm_unmap(struct mm* mm, uint32_t start, uint32_t size);
+int mm_protect(struct mm* mm, uint32_t start, uint32_t size, uint32_t flags);
+int mm_map_stack(struct mm* mm);
+uint32_t mm_stack_size(struct mm* mm);
+void mm_set_brk(struct mm* mm, uint32_t start);
+uint32_t mm_brk(struct mm* mm, uint32_t brk);
+
+// paging_fault'tan: çözülürse 1
+int vm_fault(uint32_t addr, uint32_t err);
+
+#endif
@@ -0,0 +1,75 @@
+#include "workqueue.h"
+#include "process.h"
+#include "memory.h"
+
+// Work queue: kernel'in arka planda yapacağı işler (ISO preload, banner
+// animasyonu). queue_work'e verilen işler sırayla worker kernel
+// thread'lerinde çalışır; shell tuş beklerken ya da uyurken CPU onlara
+// geçer. Ring 0 kesilmediği için uzun işler arada process_cond_resched
+// çağırır, yoksa shell işin bitmesini bekler.
+
+static struct work* work_head = 0;
+static struct work* work_tail = 0;
+static struct wait_queue work_wq;      // İş bekleyen worker'lar
+static uint32_t nr_workers = 0;
+
+static uint32_t irq_save() {
+    uint32_t flags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(flags) :: "memory");
+    return flags;
+}
+
+static void irq_restore(uint32_t flags) {
+    if (flags & 0x200) __asm__ volatile("sti" ::: "memory");
+}
+
+// Kernel thread'ler interrupt'lar kapalı başlar; iş açıkken çalışır ki
+// timer ve klavye işlerken de gelsin
+static void worker_thread(void* arg) {
+    (void)arg;
+    while (1) {
+        __asm__ volatile("cli");
+        while (!work_head) process_wait_event(&work_wq);
+        struct work* w = work_head;
+        work_head = w->next;
+        if (!work_head) work_tail = 0;
+        __asm__ volatile("sti");
+
+        w->fn(w->arg);
+        kfree(w);
+    }
+}
+
+int workqueue_init() {
+    for (uint32_t i = 0; i < WORKQUEUE_THREADS; i++) {
+        char name[] = "kworker/0";
+        name[8] = '0' + i;
+        uint32_t pid = process_create(name, worker_thread, 0);
+        if (!pid) break;
+        process_set_nice(process_find(pid), WORKQUEUE_NICE);
+        nr_workers++;
+    }
+    return nr_workers ? 0 : -1;
+}
+
+// fn(arg)'ı bir worker'a ver. Process context'ten çağrılır (kmalloc);
+// worker yoksa iş hemen burada çalışır.
+int queue_work(void (*fn)(void* arg), void* arg) {
+    if (!nr_workers) {
+        fn(arg);
+        return 0;
+    }
+    struct work* w = (struct work*)kmalloc(sizeof(struct work));
+    if (!w) return -1;
+    w->fn = fn;
+    w->arg = arg;
+    w->next = 0;
+
+    uint32_t flags = irq_save();
+    if (work_tail) work_tail->next = w;
+    else work_head = w;
+    work_tail = w;
+    process_wake_queue(&work_wq);
+    irq_restore(flags);
+    return 0;
+}
@@ -0,0 +1,24 @@
+#ifndef WORKQUEUE_H
+#define WORKQUEUE_H
+
+// Kendi typedef'lerimiz
+typedef unsigned char uint8_t;
+typedef unsigned short uint16_t;
+typedef unsigned int uint32_t;
+
+// Worker kernel thread sayısı: uzun bir iş (preload) kısa olanları bekletmesin
+#define WORKQUEUE_THREADS   2
+#define WORKQUEUE_NICE      10      // Shell'den (nice 0) sonra çalışırlar
+
+// Kuyruğa düşen iş: fn(arg) bir worker thread'inde çalışır
+struct work {
+    void (*fn)(void* arg);
+    void* arg;
+    struct work* next;
+};
+
+// Work queue fonksiyonları
+int workqueue_init();
+int queue_work(void (*fn)(void* arg), void* arg);
+
+#endif